@@ -0,0 +1,545 @@
+#include <M3D/Batch.hpp>
+#include <M3D/Matrix3.hpp>
+#include <M3D/Matrix4.hpp>
+#include <M3D/Quaternion.hpp>
+#include <M3D/Simd.hpp>
+#include <M3D/UnityMatrix4.hpp>
+#include <M3D/Vector3.hpp>
+#include <M3D/Vector4.hpp>
+
+#include <algorithm>
+#include <type_traits>
+
+namespace M3D
+{
+	namespace
+	{
+		static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be 3 packed floats");
+		static_assert(sizeof(Vector4) == 4 * sizeof(float), "Vector4 must be 4 packed floats");
+		static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion must be 4 packed floats");
+
+		// Index of the entry at row, column of the 16 floats of a Matrix4, or
+		// of a UnityMatrix4 when ColumnMajor.
+		template <bool ColumnMajor>
+		constexpr std::size_t entry(const std::size_t row, const std::size_t column)
+		{
+			return ColumnMajor ? 4 * column + row : 4 * row + column;
+		}
+
+		// The entries of a matrix broadcast into registers once per batch, in
+		// row-major order whatever the layout of A.
+		struct SplatMatrix4
+		{
+			simd::float4 m[16];
+
+			template <bool ColumnMajor>
+			static SplatMatrix4 of(const float* A)
+			{
+				SplatMatrix4 splatA;
+				for (unsigned int i = 0; i < 16; ++i) splatA.m[i] = simd::splat(A[entry<ColumnMajor>(i / 4, i % 4)]);
+				return splatA;
+			}
+		};
+
+		// Applies the upper 3x4 block of A to four points held as one register
+		// per component. w is 1 for points and 0 for directions.
+		template <bool HasTranslation>
+		inline void transform3(const SplatMatrix4& A, simd::float4& x, simd::float4& y, simd::float4& z)
+		{
+			using namespace simd;
+
+			float4 rx = HasTranslation ? madd(A.m[0], x, A.m[3]) : mul(A.m[0], x);
+			float4 ry = HasTranslation ? madd(A.m[4], x, A.m[7]) : mul(A.m[4], x);
+			float4 rz = HasTranslation ? madd(A.m[8], x, A.m[11]) : mul(A.m[8], x);
+
+			rx = madd(A.m[1], y, rx);
+			ry = madd(A.m[5], y, ry);
+			rz = madd(A.m[9], y, rz);
+
+			x = madd(A.m[2], z, rx);
+			y = madd(A.m[6], z, ry);
+			z = madd(A.m[10], z, rz);
+		}
+
+		template <bool HasTranslation, bool ColumnMajor>
+		void transform3Batch(const float* a, const Vector3* in, Vector3* out, std::size_t count)
+		{
+			const SplatMatrix4 splatA = SplatMatrix4::of<ColumnMajor>(a);
+
+			const float* src = &in->x;
+			float* dst = &out->x;
+
+			std::size_t i = 0;
+			for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+			{
+				simd::float4 x, y, z;
+				simd::loadInterleaved3(src + 3 * i, x, y, z);
+				transform3<HasTranslation>(splatA, x, y, z);
+				simd::storeInterleaved3(dst + 3 * i, x, y, z);
+			}
+
+			// Remaining elements.
+			for (; i < count; ++i)
+			{
+				const Vector3 v = in[i];
+				const float w = HasTranslation ? 1.0f : 0.0f;
+				out[i] = Vector3(
+					a[entry<ColumnMajor>(0, 0)] * v.x + a[entry<ColumnMajor>(0, 1)] * v.y + a[entry<ColumnMajor>(0, 2)] * v.z
+						+ a[entry<ColumnMajor>(0, 3)] * w,
+					a[entry<ColumnMajor>(1, 0)] * v.x + a[entry<ColumnMajor>(1, 1)] * v.y + a[entry<ColumnMajor>(1, 2)] * v.z
+						+ a[entry<ColumnMajor>(1, 3)] * w,
+					a[entry<ColumnMajor>(2, 0)] * v.x + a[entry<ColumnMajor>(2, 1)] * v.y + a[entry<ColumnMajor>(2, 2)] * v.z
+						+ a[entry<ColumnMajor>(2, 3)] * w
+				);
+			}
+		}
+
+		template <bool ColumnMajor>
+		void transformHomogeneousBatch(const float* a, const Vector4* in, Vector4* out, std::size_t count)
+		{
+			using namespace simd;
+
+			const SplatMatrix4 splatA = SplatMatrix4::of<ColumnMajor>(a);
+
+			const float* src = &in->x;
+			float* dst = &out->x;
+
+			std::size_t i = 0;
+			for (; i + WIDTH <= count; i += WIDTH)
+			{
+				// Four vectors in, transposed so that each register holds one
+				// component of all four.
+				float4 x = load(src + 4 * i + 0);
+				float4 y = load(src + 4 * i + 4);
+				float4 z = load(src + 4 * i + 8);
+				float4 w = load(src + 4 * i + 12);
+				transpose(x, y, z, w);
+
+				float4 r[4];
+				for (unsigned int row = 0; row < 4; ++row)
+				{
+					r[row] = mul(splatA.m[4 * row + 0], x);
+					r[row] = madd(splatA.m[4 * row + 1], y, r[row]);
+					r[row] = madd(splatA.m[4 * row + 2], z, r[row]);
+					r[row] = madd(splatA.m[4 * row + 3], w, r[row]);
+				}
+
+				transpose(r[0], r[1], r[2], r[3]);
+				store(dst + 4 * i + 0, r[0]);
+				store(dst + 4 * i + 4, r[1]);
+				store(dst + 4 * i + 8, r[2]);
+				store(dst + 4 * i + 12, r[3]);
+			}
+
+			// Remaining elements.
+			for (; i < count; ++i)
+			{
+				if (ColumnMajor)
+				{
+					multiplyVector4Matrix4(src + 4 * i, a, dst + 4 * i);
+				}
+				else
+				{
+					multiplyMatrix4Vector4(a, src + 4 * i, dst + 4 * i);
+				}
+			}
+		}
+
+		// Sines and cosines of four Euler triples, one register per axis.
+		struct EulerSinCos
+		{
+			simd::float4 sx, cx, sy, cy, sz, cz;
+
+			// Loads four packed triples and scales them to radians (or half
+			// radians, for quaternions) before taking their sines and cosines.
+			EulerSinCos(const float* angles, const float scale)
+			{
+				using namespace simd;
+
+				float4 x, y, z;
+				loadInterleaved3(angles, x, y, z);
+				const float4 s = splat(scale);
+				sinCos(mul(x, s), sx, cx);
+				sinCos(mul(y, s), sy, cy);
+				sinCos(mul(z, s), sz, cz);
+			}
+		};
+
+		// Row-major entries of the rotation matrices.
+		template <EulerConvention C>
+		void rotationEntries(const EulerSinCos& a, simd::float4* e);
+
+		template <>
+		void rotationEntries<EulerConvention::XYZRadians>(const EulerSinCos& a, simd::float4* e)
+		{
+			// Same entries as Matrix3::euler().
+			using namespace simd;
+
+			const float4 s1s2 = mul(a.sx, a.sy);
+			const float4 c1s2 = mul(a.cx, a.sy);
+			e[0] = mul(a.cy, a.cz);
+			e[1] = mul(sub(splat(0.0f), a.cy), a.sz);
+			e[2] = a.sy;
+			e[3] = madd(s1s2, a.cz, mul(a.cx, a.sz));
+			e[4] = sub(mul(a.cx, a.cz), mul(s1s2, a.sz));
+			e[5] = mul(sub(splat(0.0f), a.cy), a.sx);
+			e[6] = sub(mul(a.sx, a.sz), mul(c1s2, a.cz));
+			e[7] = madd(c1s2, a.sz, mul(a.sx, a.cz));
+			e[8] = mul(a.cx, a.cy);
+		}
+
+		template <>
+		void rotationEntries<EulerConvention::UnityZXYDegrees>(const EulerSinCos& a, simd::float4* e)
+		{
+			// Ry * Rx * Rz.
+			using namespace simd;
+
+			const float4 sysx = mul(a.sy, a.sx);
+			const float4 cysx = mul(a.cy, a.sx);
+			e[0] = madd(sysx, a.sz, mul(a.cy, a.cz));
+			e[1] = sub(mul(sysx, a.cz), mul(a.cy, a.sz));
+			e[2] = mul(a.sy, a.cx);
+			e[3] = mul(a.cx, a.sz);
+			e[4] = mul(a.cx, a.cz);
+			e[5] = sub(splat(0.0f), a.sx);
+			e[6] = sub(mul(cysx, a.sz), mul(a.sy, a.cz));
+			e[7] = madd(cysx, a.cz, mul(a.sy, a.sz));
+			e[8] = mul(a.cy, a.cx);
+		}
+
+		// (w, x, y, z) of the rotations, from the half angles.
+		template <EulerConvention C>
+		void quaternionComponents(const EulerSinCos& a, simd::float4* q);
+
+		template <>
+		void quaternionComponents<EulerConvention::XYZRadians>(const EulerSinCos& a, simd::float4* q)
+		{
+			// Same components as Quaternion::euler().
+			using namespace simd;
+
+			const float4 cxcy = mul(a.cx, a.cy);
+			const float4 sxsy = mul(a.sx, a.sy);
+			const float4 sxcy = mul(a.sx, a.cy);
+			const float4 cxsy = mul(a.cx, a.sy);
+			q[0] = sub(mul(cxcy, a.cz), mul(sxsy, a.sz));
+			q[1] = madd(sxcy, a.cz, mul(cxsy, a.sz));
+			q[2] = sub(mul(cxsy, a.cz), mul(sxcy, a.sz));
+			q[3] = madd(cxcy, a.sz, mul(sxsy, a.cz));
+		}
+
+		template <>
+		void quaternionComponents<EulerConvention::UnityZXYDegrees>(const EulerSinCos& a, simd::float4* q)
+		{
+			// qy * qx * qz.
+			using namespace simd;
+
+			const float4 cycx = mul(a.cy, a.cx);
+			const float4 sysx = mul(a.sy, a.sx);
+			const float4 cysx = mul(a.cy, a.sx);
+			const float4 sycx = mul(a.sy, a.cx);
+			q[0] = madd(cycx, a.cz, mul(sysx, a.sz));
+			q[1] = madd(cysx, a.cz, mul(sycx, a.sz));
+			q[2] = sub(mul(sycx, a.cz), mul(cysx, a.sz));
+			q[3] = sub(mul(cycx, a.sz), mul(sysx, a.cz));
+		}
+
+		// Writes the four rotations held in a to out[0..3].
+		template <EulerConvention C>
+		void convertEuler(const EulerSinCos& a, Quaternion* out)
+		{
+			simd::float4 q[4];
+			quaternionComponents<C>(a, q);
+			simd::transpose(q[0], q[1], q[2], q[3]);
+			for (unsigned int k = 0; k < 4; ++k) simd::store(&out[k].w, q[k]);
+		}
+
+		template <EulerConvention C>
+		void convertEuler(const EulerSinCos& a, Matrix3* out)
+		{
+			simd::float4 e[9];
+			rotationEntries<C>(a, e);
+
+			float lanes[9][4];
+			for (unsigned int j = 0; j < 9; ++j) simd::store(lanes[j], e[j]);
+
+			for (unsigned int k = 0; k < 4; ++k)
+			{
+				out[k] = Matrix3(
+					lanes[0][k], lanes[1][k], lanes[2][k],
+					lanes[3][k], lanes[4][k], lanes[5][k],
+					lanes[6][k], lanes[7][k], lanes[8][k]
+				);
+			}
+		}
+
+		template <EulerConvention C>
+		void convertEuler(const EulerSinCos& a, Matrix4* out)
+		{
+			simd::float4 e[9];
+			rotationEntries<C>(a, e);
+
+			float lanes[9][4];
+			for (unsigned int j = 0; j < 9; ++j) simd::store(lanes[j], e[j]);
+
+			for (unsigned int k = 0; k < 4; ++k)
+			{
+				out[k] = Matrix4(
+					lanes[0][k], lanes[1][k], lanes[2][k], 0.0f,
+					lanes[3][k], lanes[4][k], lanes[5][k], 0.0f,
+					lanes[6][k], lanes[7][k], lanes[8][k], 0.0f,
+					0.0f, 0.0f, 0.0f, 1.0f
+				);
+			}
+		}
+
+		template <EulerConvention C, typename T>
+		void eulerBatch(const Vector3* angles, T* out, std::size_t count)
+		{
+			// Quaternions are built from half angles.
+			const float toRadians = C == EulerConvention::UnityZXYDegrees ? 0.0174532925f : 1.0f;
+			const float scale = std::is_same<T, Quaternion>::value ? 0.5f * toRadians : toRadians;
+
+			std::size_t i = 0;
+			for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+			{
+				convertEuler<C>(EulerSinCos(&angles[i].x, scale), out + i);
+			}
+
+			// The remaining elements are padded to a full group so that they
+			// go through the same approximation as the others.
+			if (i < count)
+			{
+				Vector3 paddedAngles[simd::WIDTH];
+				T paddedOut[simd::WIDTH];
+				std::copy(angles + i, angles + count, paddedAngles);
+				convertEuler<C>(EulerSinCos(&paddedAngles[0].x, scale), paddedOut);
+				std::copy(paddedOut, paddedOut + (count - i), out + i);
+			}
+		}
+
+		// Interpolates four pairs of quaternions held as one register per
+		// component, as slerp() or nlerp() in Quaternion.cpp, with masks in
+		// place of their branches.
+		template <bool Spherical>
+		inline void interpolate4(const float* from, const float* to, const simd::float4 t, float* out)
+		{
+			using namespace simd;
+
+			float4 w0 = load(from + 0), x0 = load(from + 4), y0 = load(from + 8), z0 = load(from + 12);
+			float4 w1 = load(to + 0), x1 = load(to + 4), y1 = load(to + 8), z1 = load(to + 12);
+			transpose(w0, x0, y0, z0);
+			transpose(w1, x1, y1, z1);
+
+			const float4 zero = splat(0.0f);
+			const float4 one = splat(1.0f);
+			const float4 cosHalfAngle = madd(z0, z1, madd(y0, y1, madd(x0, x1, mul(w0, w1))));
+			const float4 u = sub(one, t);
+			float4 s0 = u;
+			float4 s1 = t;
+
+			if (Spherical)
+			{
+				const float4 c = min(abs(cosHalfAngle), one);
+				const float4 a2 = mul(splat(2.0f), sub(one, c));
+				const float4 sixth = splat(1.0f / 6.0f);
+				const float4 series0 = mul(u, sub(one, mul(mul(sub(mul(u, u), one), a2), sixth)));
+				const float4 series1 = mul(t, sub(one, mul(mul(sub(mul(t, t), one), a2), sixth)));
+
+				// Lanes within 3.6 degrees divide by a sine close to 0 here,
+				// and take the series instead.
+				const float4 halfAngle = acos(c);
+				const float4 invSin = div(one, sqrt(sub(one, mul(c, c))));
+				float4 sin0, sin1, cos0, cos1;
+				sinCos(mul(u, halfAngle), sin0, cos0);
+				sinCos(mul(t, halfAngle), sin1, cos1);
+
+				const mask4 linear = greaterThan(c, splat(0.999507f));
+				s0 = select(linear, series0, mul(sin0, invSin));
+				s1 = select(linear, series1, mul(sin1, invSin));
+			}
+			s1 = select(greaterThan(zero, cosHalfAngle), sub(zero, s1), s1);
+
+			float4 w = madd(w1, s1, mul(w0, s0));
+			float4 x = madd(x1, s1, mul(x0, s0));
+			float4 y = madd(y1, s1, mul(y0, s0));
+			float4 z = madd(z1, s1, mul(z0, s0));
+			const float4 invNorm = div(one, sqrt(madd(z, z, madd(y, y, madd(x, x, mul(w, w))))));
+			w = mul(w, invNorm);
+			x = mul(x, invNorm);
+			y = mul(y, invNorm);
+			z = mul(z, invNorm);
+
+			transpose(w, x, y, z);
+			store(out + 0, w);
+			store(out + 4, x);
+			store(out + 8, y);
+			store(out + 12, z);
+		}
+
+		// t holds a factor per pair, or is null and all use factor.
+		template <bool Spherical>
+		void interpolateBatch(const Quaternion* from, const Quaternion* to, const float* t, const float factor,
+			Quaternion* out, std::size_t count)
+		{
+			using namespace simd;
+
+			const float4 splatFactor = splat(factor);
+
+			std::size_t i = 0;
+			for (; i + WIDTH <= count; i += WIDTH)
+			{
+				interpolate4<Spherical>(&from[i].w, &to[i].w, t ? load(t + i) : splatFactor, &out[i].w);
+			}
+
+			// The remaining pairs are padded to a full group, as for euler().
+			if (i < count)
+			{
+				Quaternion paddedFrom[WIDTH], paddedTo[WIDTH], paddedOut[WIDTH];
+				float paddedT[WIDTH] = {};
+				std::copy(from + i, from + count, paddedFrom);
+				std::copy(to + i, to + count, paddedTo);
+				if (t)
+				{
+					std::copy(t + i, t + count, paddedT);
+				}
+				interpolate4<Spherical>(&paddedFrom[0].w, &paddedTo[0].w, t ? load(paddedT) : splatFactor,
+					&paddedOut[0].w);
+				std::copy(paddedOut, paddedOut + (count - i), out + i);
+			}
+		}
+	}
+
+	void transformPoints(const Matrix4& A, const Vector3* in, Vector3* out, std::size_t count)
+	{
+		transform3Batch<true, false>(A.data(), in, out, count);
+	}
+
+	void transformDirections(const Matrix4& A, const Vector3* in, Vector3* out, std::size_t count)
+	{
+		transform3Batch<false, false>(A.data(), in, out, count);
+	}
+
+	void transformHomogeneous(const Matrix4& A, const Vector4* in, Vector4* out, std::size_t count)
+	{
+		transformHomogeneousBatch<false>(A.data(), in, out, count);
+	}
+
+	void transformPoints(const UnityMatrix4& A, const Vector3* in, Vector3* out, std::size_t count)
+	{
+		transform3Batch<true, true>(A.data(), in, out, count);
+	}
+
+	void transformDirections(const UnityMatrix4& A, const Vector3* in, Vector3* out, std::size_t count)
+	{
+		transform3Batch<false, true>(A.data(), in, out, count);
+	}
+
+	void transformHomogeneous(const UnityMatrix4& A, const Vector4* in, Vector4* out, std::size_t count)
+	{
+		transformHomogeneousBatch<true>(A.data(), in, out, count);
+	}
+
+	void rotate(const Quaternion& q, const Vector3* in, Vector3* out, std::size_t count)
+	{
+		using namespace simd;
+
+		const float4 qw = splat(q.w), qx = splat(q.x), qy = splat(q.y), qz = splat(q.z);
+
+		const float* src = &in->x;
+		float* dst = &out->x;
+
+		std::size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			float4 x, y, z;
+			loadInterleaved3(src + 3 * i, x, y, z);
+			rotateVector3(qw, qx, qy, qz, x, y, z);
+			storeInterleaved3(dst + 3 * i, x, y, z);
+		}
+
+		for (; i < count; ++i) out[i] = q * in[i];
+	}
+
+	void rotate(const Quaternion* q, const Vector3* in, Vector3* out, std::size_t count)
+	{
+		using namespace simd;
+
+		const float* quaternions = &q->w;
+		const float* src = &in->x;
+		float* dst = &out->x;
+
+		std::size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			// Four quaternions in, transposed to one register per component.
+			float4 qw = load(quaternions + 4 * i + 0);
+			float4 qx = load(quaternions + 4 * i + 4);
+			float4 qy = load(quaternions + 4 * i + 8);
+			float4 qz = load(quaternions + 4 * i + 12);
+			transpose(qw, qx, qy, qz);
+
+			float4 x, y, z;
+			loadInterleaved3(src + 3 * i, x, y, z);
+			rotateVector3(qw, qx, qy, qz, x, y, z);
+			storeInterleaved3(dst + 3 * i, x, y, z);
+		}
+
+		for (; i < count; ++i) out[i] = q[i] * in[i];
+	}
+
+	void slerp(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, std::size_t count)
+	{
+		interpolateBatch<true>(from, to, t, 0.0f, out, count);
+	}
+
+	void slerp(const Quaternion* from, const Quaternion* to, float t, Quaternion* out, std::size_t count)
+	{
+		interpolateBatch<true>(from, to, nullptr, t, out, count);
+	}
+
+	void nlerp(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, std::size_t count)
+	{
+		interpolateBatch<false>(from, to, t, 0.0f, out, count);
+	}
+
+	void nlerp(const Quaternion* from, const Quaternion* to, float t, Quaternion* out, std::size_t count)
+	{
+		interpolateBatch<false>(from, to, nullptr, t, out, count);
+	}
+
+	void euler(const Vector3* angles, Quaternion* out, std::size_t count, EulerConvention convention)
+	{
+		if (convention == EulerConvention::UnityZXYDegrees)
+		{
+			eulerBatch<EulerConvention::UnityZXYDegrees>(angles, out, count);
+		}
+		else
+		{
+			eulerBatch<EulerConvention::XYZRadians>(angles, out, count);
+		}
+	}
+
+	void euler(const Vector3* angles, Matrix3* out, std::size_t count, EulerConvention convention)
+	{
+		if (convention == EulerConvention::UnityZXYDegrees)
+		{
+			eulerBatch<EulerConvention::UnityZXYDegrees>(angles, out, count);
+		}
+		else
+		{
+			eulerBatch<EulerConvention::XYZRadians>(angles, out, count);
+		}
+	}
+
+	void euler(const Vector3* angles, Matrix4* out, std::size_t count, EulerConvention convention)
+	{
+		if (convention == EulerConvention::UnityZXYDegrees)
+		{
+			eulerBatch<EulerConvention::UnityZXYDegrees>(angles, out, count);
+		}
+		else
+		{
+			eulerBatch<EulerConvention::XYZRadians>(angles, out, count);
+		}
+	}
+}
@@ -0,0 +1,209 @@
+#include <M3D/Culling.hpp>
+#include <M3D/Matrix4.hpp>
+#include <M3D/Simd.hpp>
+#include <M3D/UnityMatrix4.hpp>
+#include <M3D/Vector3.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace M3D
+{
+	namespace
+	{
+		static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be 3 packed floats");
+
+		// The float4 operations the tests need, four objects at a time.
+		struct Lanes4
+		{
+			typedef simd::float4 type;
+			static const unsigned int WIDTH = 4;
+
+			static type splat(const float s) { return simd::splat(s); }
+			static type load(const float* p) { return simd::load(p); }
+			static void loadInterleaved3(const float* p, type& x, type& y, type& z) { simd::loadInterleaved3(p, x, y, z); }
+			static type add(const type a, const type b) { return simd::add(a, b); }
+			static type madd(const type a, const type b, const type c) { return simd::madd(a, b, c); }
+			static type min(const type a, const type b) { return simd::min(a, b); }
+
+			// Lanes that are not negative, or NaN.
+			static unsigned int notNegative(const type a)
+			{
+				return ~simd::moveMask(simd::greaterThan(simd::splat(0.0f), a)) & 15u;
+			}
+		};
+
+#if defined(M3D_SIMD_AVX)
+		// The same with 256-bit registers, eight objects at a time.
+		struct Lanes8
+		{
+			typedef __m256 type;
+			static const unsigned int WIDTH = 8;
+
+			static type splat(const float s) { return _mm256_set1_ps(s); }
+			static type load(const float* p) { return _mm256_loadu_ps(p); }
+
+			static void loadInterleaved3(const float* p, type& x, type& y, type& z)
+			{
+				simd::float4 x0, y0, z0, x1, y1, z1;
+				simd::loadInterleaved3(p, x0, y0, z0);
+				simd::loadInterleaved3(p + 12, x1, y1, z1);
+				x = _mm256_insertf128_ps(_mm256_castps128_ps256(x0), x1, 1);
+				y = _mm256_insertf128_ps(_mm256_castps128_ps256(y0), y1, 1);
+				z = _mm256_insertf128_ps(_mm256_castps128_ps256(z0), z1, 1);
+			}
+
+			static type add(const type a, const type b) { return _mm256_add_ps(a, b); }
+
+			static type madd(const type a, const type b, const type c)
+			{
+	#if defined(__FMA__)
+				return _mm256_fmadd_ps(a, b, c);
+	#else
+				return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+	#endif
+			}
+
+			static type min(const type a, const type b) { return _mm256_min_ps(a, b); }
+
+			static unsigned int notNegative(const type a)
+			{
+				return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_NLT_UQ)));
+			}
+		};
+
+		typedef Lanes8 Lanes;
+#else
+		typedef Lanes4 Lanes;
+#endif
+
+		// The planes broadcast into registers once per call, with the
+		// absolute values of the normals for the box test.
+		template <typename L>
+		struct SplatPlanes
+		{
+			typename L::type x[6], y[6], z[6], w[6], absX[6], absY[6], absZ[6];
+
+			explicit SplatPlanes(const Frustum& frustum)
+			{
+				for (unsigned int i = 0; i < 6; ++i)
+				{
+					const Vector4& p = frustum.planes[i];
+					x[i] = L::splat(p.x);
+					y[i] = L::splat(p.y);
+					z[i] = L::splat(p.z);
+					w[i] = L::splat(p.w);
+					absX[i] = L::splat(std::fabs(p.x));
+					absY[i] = L::splat(std::fabs(p.y));
+					absZ[i] = L::splat(std::fabs(p.z));
+				}
+			}
+		};
+
+		// Mask of the objects of a group that are not entirely behind a
+		// plane: the smallest over the planes of the signed distance of the
+		// center plus the radius, or for boxes the extent projected on the
+		// normal, is not negative.
+		template <typename L, bool Boxes>
+		unsigned int testGroup(const SplatPlanes<L>& planes, const float* centers, const float* radii, const float* extents)
+		{
+			typename L::type cx, cy, cz, ex, ey, ez, r;
+			L::loadInterleaved3(centers, cx, cy, cz);
+			if (Boxes)
+			{
+				L::loadInterleaved3(extents, ex, ey, ez);
+			}
+			else
+			{
+				r = L::load(radii);
+			}
+
+			typename L::type nearest = L::splat(0.0f);
+			for (unsigned int i = 0; i < 6; ++i)
+			{
+				const typename L::type distance = L::madd(planes.z[i], cz, L::madd(planes.y[i], cy, L::madd(planes.x[i], cx, planes.w[i])));
+				const typename L::type reach = Boxes
+					? L::madd(planes.absZ[i], ez, L::madd(planes.absY[i], ey, L::madd(planes.absX[i], ex, distance)))
+					: L::add(distance, r);
+				nearest = i == 0 ? reach : L::min(nearest, reach);
+			}
+			return L::notNegative(nearest);
+		}
+
+		template <typename L, bool Boxes>
+		std::size_t cull(const Frustum& frustum, const Vector3* centers, const float* radii, const Vector3* extents,
+			const std::size_t count, std::uint32_t* visible)
+		{
+			const SplatPlanes<L> planes(frustum);
+			std::size_t found = 0;
+
+			// Every index of the group is written and the count only advances
+			// past the visible ones, which keeps the loop free of branches.
+			// found never passes i, so the writes stay within count.
+			std::size_t i = 0;
+			for (; i + L::WIDTH <= count; i += L::WIDTH)
+			{
+				const unsigned int mask = testGroup<L, Boxes>(planes, &centers[i].x, Boxes ? nullptr : radii + i,
+					Boxes ? &extents[i].x : nullptr);
+				for (unsigned int k = 0; k < L::WIDTH; ++k)
+				{
+					visible[found] = static_cast<std::uint32_t>(i + k);
+					found += (mask >> k) & 1u;
+				}
+			}
+
+			// The remaining objects are padded to a full group, and only
+			// written one at a time since visible may be no larger than count.
+			if (i < count)
+			{
+				const std::size_t rest = count - i;
+				Vector3 paddedCenters[L::WIDTH];
+				Vector3 paddedExtents[L::WIDTH];
+				float paddedRadii[L::WIDTH] = {};
+				std::copy(centers + i, centers + count, paddedCenters);
+				if (Boxes)
+				{
+					std::copy(extents + i, extents + count, paddedExtents);
+				}
+				else
+				{
+					std::copy(radii + i, radii + count, paddedRadii);
+				}
+
+				const unsigned int mask = testGroup<L, Boxes>(planes, &paddedCenters[0].x, paddedRadii, &paddedExtents[0].x);
+				for (unsigned int k = 0; k < rest; ++k)
+				{
+					if ((mask >> k) & 1u) visible[found++] = static_cast<std::uint32_t>(i + k);
+				}
+			}
+			return found;
+		}
+	}
+
+	Frustum::Frustum()
+	{
+		// Nothing to do.
+	}
+
+	Frustum::Frustum(const Matrix4& viewProjection)
+	{
+		viewProjection.frustumPlanes(planes);
+	}
+
+	Frustum::Frustum(const UnityMatrix4& viewProjection)
+	{
+		viewProjection.frustumPlanes(planes);
+	}
+
+	std::size_t cullSpheres(const Frustum& frustum, const Vector3* centers, const float* radii, const std::size_t count,
+		std::uint32_t* visible)
+	{
+		return cull<Lanes, false>(frustum, centers, radii, nullptr, count, visible);
+	}
+
+	std::size_t cullBoxes(const Frustum& frustum, const Vector3* centers, const Vector3* extents, const std::size_t count,
+		std::uint32_t* visible)
+	{
+		return cull<Lanes, true>(frustum, centers, nullptr, extents, count, visible);
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+
+namespace M3D
+{
+	class Matrix3;
+	class Matrix4;
+	class Quaternion;
+	class UnityMatrix4;
+	class Vector3;
+	class Vector4;
+
+	// Batch versions of the Matrix4 and Quaternion products. Each function loads the matrix
+	// once and then streams over count contiguous elements, several at a
+	// time. out may be the same array as in, but the two must not otherwise
+	// overlap.
+
+	// out[i] = (A * Vector4(in[i], 1)).xyz. The w row of A is ignored, so no
+	// perspective divide is performed.
+	void transformPoints(const Matrix4& A, const Vector3* in, Vector3* out, std::size_t count);
+
+	// out[i] = (A * Vector4(in[i], 0)).xyz. Translation is ignored.
+	void transformDirections(const Matrix4& A, const Vector3* in, Vector3* out, std::size_t count);
+
+	// out[i] = A * in[i].
+	void transformHomogeneous(const Matrix4& A, const Vector4* in, Vector4* out, std::size_t count);
+
+	// As above, for a matrix read in place from a Unity Matrix4x4.
+	void transformPoints(const UnityMatrix4& A, const Vector3* in, Vector3* out, std::size_t count);
+	void transformDirections(const UnityMatrix4& A, const Vector3* in, Vector3* out, std::size_t count);
+	void transformHomogeneous(const UnityMatrix4& A, const Vector4* in, Vector4* out, std::size_t count);
+
+	// out[i] = q * in[i].
+	void rotate(const Quaternion& q, const Vector3* in, Vector3* out, std::size_t count);
+
+	// out[i] = q[i] * in[i].
+	void rotate(const Quaternion* q, const Vector3* in, Vector3* out, std::size_t count);
+
+	// out[i] = slerp(from[i], to[i], t[i]), or with the same t for all.
+	// The arc cosine and sines are those of Precision::Fast, so the results
+	// are within about 2e-4 degrees of the exact slerp().
+	void slerp(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, std::size_t count);
+	void slerp(const Quaternion* from, const Quaternion* to, float t, Quaternion* out, std::size_t count);
+
+	// out[i] = nlerp(from[i], to[i], t[i]), or with the same t for all.
+	void nlerp(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, std::size_t count);
+	void nlerp(const Quaternion* from, const Quaternion* to, float t, Quaternion* out, std::size_t count);
+
+	// How the Euler angle triples passed to euler() are interpreted.
+	enum class EulerConvention
+	{
+		// Radians, R = Rx(x) * Ry(y) * Rz(z), as Quaternion::euler() and
+		// Matrix4::euler().
+		XYZRadians,
+
+		// Degrees, R = Ry(y) * Rx(x) * Rz(z): z is applied first, then x,
+		// then y. This is the order of Unity's Quaternion.Euler() and
+		// Transform.eulerAngles.
+		UnityZXYDegrees
+	};
+
+	// out[i] = rotation for the Euler angles angles[i]. The sines and
+	// cosines come from simd::sinCos, so the entries are within about 2e-6
+	// of the single conversions for angles up to 1e4 radians.
+	void euler(const Vector3* angles, Quaternion* out, std::size_t count,
+		EulerConvention convention = EulerConvention::XYZRadians);
+	void euler(const Vector3* angles, Matrix3* out, std::size_t count,
+		EulerConvention convention = EulerConvention::XYZRadians);
+	void euler(const Vector3* angles, Matrix4* out, std::size_t count,
+		EulerConvention convention = EulerConvention::XYZRadians);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <M3D/Vector4.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace M3D
+{
+	class Matrix4;
+	class UnityMatrix4;
+	class Vector3;
+
+	// The planes of a view frustum, as Matrix4::frustumPlanes() returns
+	// them.
+	class Frustum
+	{
+	public:
+		Vector4 planes[6];
+
+		Frustum();
+		explicit Frustum(const Matrix4& viewProjection);
+		explicit Frustum(const UnityMatrix4& viewProjection);
+	};
+
+	// Bulk visibility tests against a frustum. Each writes the indices of
+	// the objects that are at least partly inside to visible, in increasing
+	// order, and returns how many there are. visible must hold count
+	// indices.
+	//
+	// The tests reject an object only when it lies entirely behind one of
+	// the planes, so objects near a corner of the frustum, outside of it
+	// but across no single plane, are kept. Objects with NaN coordinates
+	// are kept too. Eight objects are tested per instruction with AVX, four
+	// with SSE and NEON.
+
+	// Spheres of center centers[i] and radius radii[i].
+	std::size_t cullSpheres(const Frustum& frustum, const Vector3* centers, const float* radii, std::size_t count,
+		std::uint32_t* visible);
+
+	// Axis-aligned boxes of center centers[i] and half size extents[i], as
+	// Unity's Bounds.center and Bounds.extents.
+	std::size_t cullBoxes(const Frustum& frustum, const Vector3* centers, const Vector3* extents, std::size_t count,
+		std::uint32_t* visible);
+}
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <M3D/Vector3.hpp>
+#include <M3D/Vector4.hpp>
+
+#include <cmath>
+#include <type_traits>
+
+namespace M3D
+{
+	// Opt-in expression templates for Vector3 and Vector4.
+	//
+	// Wrapping an operand in lazy() turns the arithmetic around it into a
+	// tree of small value types instead of a chain of Vector temporaries.
+	// Nothing is computed until the tree is converted back to a vector, at
+	// which point each component is evaluated in one pass, with a * b + c
+	// patterns fused into FMA where the target has a fast one:
+	//
+	//	using namespace M3D::expr;
+	//	const Vector3 r = lazy(v) + q.w * lazy(t) + cross(lazy(qv), lazy(t));
+	//	const Vector3 p = lerp(lazy(from), to, factor);
+	//
+	// Nodes hold their operands by value, so an expression may be kept in an
+	// auto variable and evaluated later.
+	namespace expr
+	{
+		// a * b + c, as a single rounding when the hardware FMA is fast. Not
+		// constexpr, since std::fma is not constexpr in C++17, so expressions
+		// that go through it are evaluated at run time only.
+		inline float madd(const float a, const float b, const float c)
+		{
+#if defined(FP_FAST_FMAF)
+			return std::fma(a, b, c);
+#else
+			return a * b + c;
+#endif
+		}
+
+		// Vector type an expression of N components evaluates to.
+		template <int N> struct Evaluator;
+
+		template <>
+		struct Evaluator<3>
+		{
+			typedef Vector3 type;
+			template <typename E>
+			static constexpr Vector3 eval(const E& e) { return Vector3(e[0], e[1], e[2]); }
+		};
+
+		template <>
+		struct Evaluator<4>
+		{
+			typedef Vector4 type;
+			template <typename E>
+			static constexpr Vector4 eval(const E& e) { return Vector4(e[0], e[1], e[2], e[3]); }
+		};
+
+		template <typename E>
+		struct Expression
+		{
+			constexpr const E& derived() const
+			{
+				return static_cast<const E&>(*this);
+			}
+
+			// Evaluates the whole tree, one component at a time. F delays the
+			// lookup of E::size until E is complete.
+			template <typename V, typename F = E, typename = typename std::enable_if<std::is_same<V, typename Evaluator<F::size>::type>::value>::type>
+			constexpr operator V() const
+			{
+				return Evaluator<F::size>::eval(derived());
+			}
+		};
+
+		// Number of components of a vector type.
+		template <typename V> struct Dimension;
+		template <> struct Dimension<Vector3> : std::integral_constant<int, 3> {};
+		template <> struct Dimension<Vector4> : std::integral_constant<int, 4> {};
+
+		constexpr float component(const Vector3& v, const int i)
+		{
+			return i == 0 ? v.x : (i == 1 ? v.y : v.z);
+		}
+
+		constexpr float component(const Vector4& v, const int i)
+		{
+			return i == 0 ? v.x : (i == 1 ? v.y : (i == 2 ? v.z : v.w));
+		}
+
+		// Leaf node holding a copy of a vector.
+		template <typename V>
+		struct Terminal : Expression<Terminal<V>>
+		{
+			static constexpr int size = Dimension<V>::value;
+			V v;
+
+			constexpr explicit Terminal(const V& v_) : v(v_) {}
+			constexpr float operator[](const int i) const { return component(v, i); }
+		};
+
+		template <typename E>
+		struct Negation : Expression<Negation<E>>
+		{
+			static constexpr int size = E::size;
+			E e;
+
+			constexpr explicit Negation(const E& e_) : e(e_) {}
+			constexpr float operator[](const int i) const { return -e[i]; }
+		};
+
+		// s * e.
+		template <typename E>
+		struct Scaled : Expression<Scaled<E>>
+		{
+			static constexpr int size = E::size;
+			E e;
+			float s;
+
+			constexpr Scaled(const E& e_, const float s_) : e(e_), s(s_) {}
+			constexpr float operator[](const int i) const { return s * e[i]; }
+		};
+
+		// Component-wise product, as scale().
+		template <typename L, typename R>
+		struct Product : Expression<Product<L, R>>
+		{
+			static_assert(L::size == R::size, "Operands must have the same dimension");
+			static constexpr int size = L::size;
+			L lhs;
+			R rhs;
+
+			constexpr Product(const L& lhs_, const R& rhs_) : lhs(lhs_), rhs(rhs_) {}
+			constexpr float operator[](const int i) const { return lhs[i] * rhs[i]; }
+		};
+
+		// Fusable terms: s * e and component-wise products. addTo() and
+		// subtractFrom() return c + term[i] and c - term[i], as one madd for
+		// fusable terms.
+		template <typename E> struct IsFusable : std::false_type {};
+		template <typename E> struct IsFusable<Scaled<E>> : std::true_type {};
+		template <typename L, typename R> struct IsFusable<Product<L, R>> : std::true_type {};
+
+		template <typename E>
+		constexpr float addTo(const E& term, const int i, const float c)
+		{
+			return term[i] + c;
+		}
+
+		template <typename E>
+		constexpr float addTo(const Scaled<E>& term, const int i, const float c)
+		{
+			return madd(term.s, term.e[i], c);
+		}
+
+		template <typename L, typename R>
+		constexpr float addTo(const Product<L, R>& term, const int i, const float c)
+		{
+			return madd(term.lhs[i], term.rhs[i], c);
+		}
+
+		template <typename E>
+		constexpr float subtractFrom(const E& term, const int i, const float c)
+		{
+			return c - term[i];
+		}
+
+		template <typename E>
+		constexpr float subtractFrom(const Scaled<E>& term, const int i, const float c)
+		{
+			return madd(-term.s, term.e[i], c);
+		}
+
+		template <typename L, typename R>
+		constexpr float subtractFrom(const Product<L, R>& term, const int i, const float c)
+		{
+			return madd(-term.lhs[i], term.rhs[i], c);
+		}
+
+		template <typename L, typename R>
+		struct Sum : Expression<Sum<L, R>>
+		{
+			static_assert(L::size == R::size, "Operands must have the same dimension");
+			static constexpr int size = L::size;
+			L lhs;
+			R rhs;
+
+			constexpr Sum(const L& lhs_, const R& rhs_) : lhs(lhs_), rhs(rhs_) {}
+			constexpr float operator[](const int i) const
+			{
+				return IsFusable<R>::value && !IsFusable<L>::value ? addTo(rhs, i, lhs[i]) : addTo(lhs, i, rhs[i]);
+			}
+		};
+
+		template <typename L, typename R>
+		struct Difference : Expression<Difference<L, R>>
+		{
+			static_assert(L::size == R::size, "Operands must have the same dimension");
+			static constexpr int size = L::size;
+			L lhs;
+			R rhs;
+
+			constexpr Difference(const L& lhs_, const R& rhs_) : lhs(lhs_), rhs(rhs_) {}
+			constexpr float operator[](const int i) const { return subtractFrom(rhs, i, lhs[i]); }
+		};
+
+		// cross(lhs, rhs). Each component reads two components of each
+		// operand; once inlined the compiler folds the repeated reads of
+		// nested operands.
+		template <typename L, typename R>
+		struct Cross : Expression<Cross<L, R>>
+		{
+			static_assert(L::size == 3 && R::size == 3, "cross is only defined for 3D vectors");
+			static constexpr int size = 3;
+			L lhs;
+			R rhs;
+
+			constexpr Cross(const L& lhs_, const R& rhs_) : lhs(lhs_), rhs(rhs_) {}
+			constexpr float operator[](const int i) const
+			{
+				return i == 0 ? madd(lhs[1], rhs[2], -lhs[2] * rhs[1])
+					: (i == 1 ? madd(lhs[2], rhs[0], -lhs[0] * rhs[2])
+					: madd(lhs[0], rhs[1], -lhs[1] * rhs[0]));
+			}
+		};
+
+		// Maps an operand to its node type: expressions stay as they are and
+		// vectors become terminals.
+		template <typename T, typename = void>
+		struct Node;
+
+		template <typename T>
+		struct Node<T, typename std::enable_if<std::is_base_of<Expression<T>, T>::value>::type>
+		{
+			typedef T type;
+			static constexpr const T& wrap(const T& t) { return t; }
+		};
+
+		template <typename T>
+		struct Node<T, typename std::enable_if<std::is_same<T, Vector3>::value || std::is_same<T, Vector4>::value>::type>
+		{
+			typedef Terminal<T> type;
+			static constexpr Terminal<T> wrap(const T& t) { return Terminal<T>(t); }
+		};
+
+		// True when the operator overloads below should take part: both
+		// operands are expressions or vectors, and at least one is an
+		// expression, so plain Vector3 arithmetic is left untouched.
+		template <typename L, typename R>
+		struct EnableBinary : std::enable_if<
+			(std::is_base_of<Expression<L>, L>::value || std::is_base_of<Expression<R>, R>::value)
+			&& (std::is_base_of<Expression<L>, L>::value || std::is_same<L, Vector3>::value || std::is_same<L, Vector4>::value)
+			&& (std::is_base_of<Expression<R>, R>::value || std::is_same<R, Vector3>::value || std::is_same<R, Vector4>::value)> {};
+
+		template <typename V>
+		constexpr Terminal<V> lazy(const V& v)
+		{
+			return Terminal<V>(v);
+		}
+
+		template <typename L, typename R, typename = typename EnableBinary<L, R>::type>
+		constexpr Sum<typename Node<L>::type, typename Node<R>::type> operator+(const L& lhs, const R& rhs)
+		{
+			return Sum<typename Node<L>::type, typename Node<R>::type>(Node<L>::wrap(lhs), Node<R>::wrap(rhs));
+		}
+
+		template <typename L, typename R, typename = typename EnableBinary<L, R>::type>
+		constexpr Difference<typename Node<L>::type, typename Node<R>::type> operator-(const L& lhs, const R& rhs)
+		{
+			return Difference<typename Node<L>::type, typename Node<R>::type>(Node<L>::wrap(lhs), Node<R>::wrap(rhs));
+		}
+
+		template <typename E>
+		constexpr Negation<E> operator-(const Expression<E>& e)
+		{
+			return Negation<E>(e.derived());
+		}
+
+		template <typename E>
+		constexpr Scaled<E> operator*(const Expression<E>& e, const float s)
+		{
+			return Scaled<E>(e.derived(), s);
+		}
+
+		template <typename E>
+		constexpr Scaled<E> operator*(const float s, const Expression<E>& e)
+		{
+			return Scaled<E>(e.derived(), s);
+		}
+
+		template <typename E>
+		constexpr Scaled<E> operator/(const Expression<E>& e, const float s)
+		{
+			return Scaled<E>(e.derived(), 1.0f / s);
+		}
+
+		template <typename L, typename R, typename = typename EnableBinary<L, R>::type>
+		constexpr Product<typename Node<L>::type, typename Node<R>::type> scale(const L& lhs, const R& rhs)
+		{
+			return Product<typename Node<L>::type, typename Node<R>::type>(Node<L>::wrap(lhs), Node<R>::wrap(rhs));
+		}
+
+		template <typename L, typename R, typename = typename EnableBinary<L, R>::type>
+		constexpr Cross<typename Node<L>::type, typename Node<R>::type> cross(const L& lhs, const R& rhs)
+		{
+			return Cross<typename Node<L>::type, typename Node<R>::type>(Node<L>::wrap(lhs), Node<R>::wrap(rhs));
+		}
+
+		// from * (1 - factor) + to * factor, as M3D::lerp, so that factor 0
+		// and 1 give from and to exactly; a multiply and a madd per component.
+		template <typename L, typename R, typename = typename EnableBinary<L, R>::type>
+		constexpr Sum<Scaled<typename Node<L>::type>, Scaled<typename Node<R>::type>>
+			lerp(const L& from, const R& to, const float factor)
+		{
+			return Node<L>::wrap(from) * (1.0f - factor) + Node<R>::wrap(to) * factor;
+		}
+
+		template <typename L, typename R, typename = typename EnableBinary<L, R>::type>
+		constexpr float dot(const L& lhs, const R& rhs)
+		{
+			typedef typename Node<L>::type LNode;
+			typedef typename Node<R>::type RNode;
+			static_assert(LNode::size == RNode::size, "Operands must have the same dimension");
+
+			const LNode l = Node<L>::wrap(lhs);
+			const RNode r = Node<R>::wrap(rhs);
+			float result = l[0] * r[0];
+			for (int i = 1; i < LNode::size; ++i) result = madd(l[i], r[i], result);
+			return result;
+		}
+
+		// Evaluates an expression into a vector in a single pass. Same as
+		// converting it to the vector type.
+		template <typename E>
+		constexpr typename Evaluator<E::size>::type eval(const Expression<E>& e)
+		{
+			return Evaluator<E::size>::eval(e.derived());
+		}
+
+		template <typename E>
+		constexpr typename Evaluator<E::size>::type& operator+=(typename Evaluator<E::size>::type& v, const Expression<E>& e)
+		{
+			return v = eval(lazy(v) + e.derived());
+		}
+
+		template <typename E>
+		constexpr typename Evaluator<E::size>::type& operator-=(typename Evaluator<E::size>::type& v, const Expression<E>& e)
+		{
+			return v = eval(lazy(v) - e.derived());
+		}
+	}
+}
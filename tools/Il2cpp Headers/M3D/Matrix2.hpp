@@ -0,0 +1,184 @@
+#pragma once
+
+#include <M3D/Vector2.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <ostream>
+#include <utility>
+
+namespace M3D
+{
+	// A 2x2 matrix stored in row-major order.
+	class Matrix2
+	{
+	public:
+		static const Matrix2 IDENTITY;
+		static const Matrix2 ZERO;
+
+		constexpr Matrix2();
+		constexpr Matrix2(const float arr[4]);
+		constexpr Matrix2(float entry00, float entry01, float entry10, float entry11);
+
+		// Entry at row index / 2, column index % 2.
+		constexpr float operator[](std::size_t index) const;
+		constexpr const float* data() const;
+
+		constexpr Matrix2 transposed() const;
+		void transpose();
+		constexpr float determinant() const;
+		Matrix2 inverse() const;
+
+		static constexpr Matrix2 scaling(const Vector2& scaleFactors);
+		static constexpr Matrix2 scaling(const float factor);
+
+		// Counter-clockwise rotation of angle radians.
+		static Matrix2 angleRotation(const float angle);
+		static Matrix2 fromToRotation(const Vector2& fromDirection, const Vector2& toDirection);
+
+	private:
+		float m[4];
+	};
+
+	bool operator==(const Matrix2& A, const Matrix2& B);
+	bool operator!=(const Matrix2& A, const Matrix2& B);
+	constexpr Matrix2 operator+(const Matrix2& A, const Matrix2& B);
+	constexpr Matrix2 operator-(const Matrix2& lhs, const Matrix2& rhs);
+	constexpr Matrix2 operator-(const Matrix2& A);
+	constexpr Matrix2 operator*(const Matrix2& A, const float s);
+	constexpr Matrix2 operator*(const float s, const Matrix2& A);
+	constexpr Vector2 operator*(const Matrix2& lhs, const Vector2& rhs);
+	constexpr Vector2 operator*(const Vector2& lhs, const Matrix2& rhs);
+	constexpr Matrix2 operator*(const Matrix2& lhs, const Matrix2& rhs);
+	std::ostream& operator <<(std::ostream& out, const Matrix2& A);
+
+	constexpr Matrix2::Matrix2()
+	: m{1.0f, 0.0f, 0.0f, 1.0f}
+	{
+		// Nothing to do.
+	}
+
+	constexpr Matrix2::Matrix2(const float arr[4])
+	: m{arr[0], arr[1], arr[2], arr[3]}
+	{
+		// Nothing to do.
+	}
+
+	constexpr Matrix2::Matrix2(float entry00, float entry01, float entry10, float entry11)
+	: m{entry00, entry01, entry10, entry11}
+	{
+		// Nothing to do.
+	}
+
+	constexpr Matrix2 Matrix2::IDENTITY = Matrix2();
+	constexpr Matrix2 Matrix2::ZERO = Matrix2(0.0f, 0.0f, 0.0f, 0.0f);
+
+	constexpr float Matrix2::operator[](std::size_t index) const
+	{
+		assert(index < 4);
+		return m[index];
+	}
+
+	constexpr const float* Matrix2::data() const
+	{
+		return m;
+	}
+
+	constexpr Matrix2 operator+(const Matrix2& A, const Matrix2& B)
+	{
+		return Matrix2(
+			A[0] + B[0], A[1] + B[1],
+			A[2] + B[2], A[3] + B[3]
+		);
+	}
+
+	constexpr Matrix2 operator-(const Matrix2& lhs, const Matrix2& rhs)
+	{
+		return Matrix2(
+			lhs[0] - rhs[0], lhs[1] - rhs[1],
+			lhs[2] - rhs[2], lhs[3] - rhs[3]
+		);
+	}
+
+	constexpr Matrix2 operator-(const Matrix2& A)
+	{
+		return Matrix2(
+			-A[0], -A[1],
+			-A[2], -A[3]
+		);
+	}
+
+	constexpr Matrix2 operator*(const Matrix2& A, const float s)
+	{
+		return Matrix2(
+			A[0] * s, A[1] * s,
+			A[2] * s, A[3] * s
+		);
+	}
+
+	constexpr Matrix2 operator*(const float s, const Matrix2& A)
+	{
+		return A * s;
+	}
+
+	constexpr Vector2 operator*(const Matrix2& lhs, const Vector2& rhs)
+	{
+		return Vector2(
+			lhs[0] * rhs.x + lhs[1] * rhs.y,
+			lhs[2] * rhs.x + lhs[3] * rhs.y
+		);
+	}
+
+	constexpr Vector2 operator*(const Vector2& lhs, const Matrix2& rhs)
+	{
+		return Vector2(
+			lhs.x * rhs[0] + lhs.y * rhs[2],
+			lhs.x * rhs[1] + lhs.y * rhs[3]
+		);
+	}
+
+	constexpr Matrix2 operator*(const Matrix2& lhs, const Matrix2& rhs)
+	{
+		return Matrix2(
+			lhs[0] * rhs[0] + lhs[1] * rhs[2],
+			lhs[0] * rhs[1] + lhs[1] * rhs[3],
+
+			lhs[2] * rhs[0] + lhs[3] * rhs[2],
+			lhs[2] * rhs[1] + lhs[3] * rhs[3]
+		);
+	}
+
+	constexpr Matrix2 Matrix2::transposed() const
+	{
+		return Matrix2(
+			m[0], m[2],
+			m[1], m[3]
+		);
+	}
+
+	inline void Matrix2::transpose()
+	{
+		std::swap(m[1], m[2]);
+	}
+
+	constexpr float Matrix2::determinant() const
+	{
+		return m[0] * m[3] - m[1] * m[2];
+	}
+
+	constexpr Matrix2 Matrix2::scaling(const Vector2& scaleFactors)
+	{
+		return Matrix2(
+			scaleFactors.x, 0.0f,
+			0.0f, scaleFactors.y
+		);
+	}
+
+	constexpr Matrix2 Matrix2::scaling(const float factor)
+	{
+		return Matrix2(
+			factor, 0.0f,
+			0.0f, factor
+		);
+	}
+}
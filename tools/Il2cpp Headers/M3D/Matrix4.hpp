@@ -0,0 +1,298 @@
+#pragma once
+
+#include <M3D/Matrix3.hpp>
+#include <M3D/Quaternion.hpp>
+#include <M3D/Simd.hpp>
+#include <M3D/Vector3.hpp>
+#include <M3D/Vector4.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <ostream>
+#include <utility>
+
+namespace M3D
+{
+	// A 4x4 matrix stored in row-major order. Points are column vectors, so
+	// translation() puts the offset in the last column.
+	class Matrix4
+	{
+	public:
+		static const Matrix4 IDENTITY;
+		static const Matrix4 ZERO;
+
+		constexpr Matrix4();
+		constexpr Matrix4(const float arr[16]);
+		constexpr Matrix4(float entry00, float entry01, float entry02, float entry03,
+			float entry10, float entry11, float entry12, float entry13,
+			float entry20, float entry21, float entry22, float entry23,
+			float entry30, float entry31, float entry32, float entry33);
+
+		// Embeds A as the upper 3x3 block.
+		explicit constexpr Matrix4(const Matrix3& A);
+
+		// Rotation matrix of the unit quaternion q.
+		explicit constexpr Matrix4(const Quaternion& q);
+
+		// Entry at row index / 4, column index % 4.
+		constexpr float operator[](std::size_t index) const;
+
+		// The 16 entries, unchecked, for the SIMD kernels.
+		constexpr const float* data() const;
+
+		constexpr Matrix4 transposed() const;
+		void transpose();
+		constexpr float determinant() const;
+
+		// General inverse. The second overload also returns the determinant,
+		// which comes out of the same computation.
+		Matrix4 inverse() const;
+		Matrix4 inverse(float& det) const;
+
+		// Inverse of a matrix whose bottom row is (0, 0, 0, 1). Only the upper
+		// 3x3 block is inverted.
+		Matrix4 inverseAffine() const;
+
+		// As inverseAffine(), for a rotation plus translation only.
+		Matrix4 inverseRigid() const;
+
+		static constexpr Matrix4 scaling(const Vector3& scaleFactors);
+		static constexpr Matrix4 scaling(const float factor);
+		static constexpr Matrix4 translation(const Vector3& translation);
+
+		// Rotation of angle radians about the unit vector axis.
+		static Matrix4 angleAxis(const float angle, const Vector3& axis);
+
+		// Rotation from XYZ Euler angles in radians.
+		static Matrix4 euler(const Vector3& eulerAngles);
+
+		// The six planes bounding the view frustum of this view-projection
+		// matrix (OpenGL clip space, as Unity's Camera.projectionMatrix), in
+		// the order of GeometryUtility.CalculateFrustumPlanes(): left, right,
+		// bottom, top, near, far. Each plane (x, y, z, w) has a unit normal
+		// pointing into the frustum, so that inside points p have
+		// dot(xyz, p) + w >= 0.
+		void frustumPlanes(Vector4 planes[6]) const;
+
+		static Matrix4 fromToRotation(const Vector3& fromDirection, const Vector3& toDirection);
+		static Matrix4 lookRotation(const Vector3& forward, const Vector3& upwards);
+		static Matrix4 lookRotation(const Vector3& target, const Vector3& eye, const Vector3& upwards);
+
+	private:
+		float m[16];
+	};
+
+	bool operator==(const Matrix4& A, const Matrix4& B);
+	bool operator!=(const Matrix4& A, const Matrix4& B);
+	constexpr Matrix4 operator+(const Matrix4& A, const Matrix4& B);
+	constexpr Matrix4 operator-(const Matrix4& lhs, const Matrix4& rhs);
+	constexpr Matrix4 operator-(const Matrix4& A);
+	constexpr Matrix4 operator*(const Matrix4& A, const float s);
+	constexpr Matrix4 operator*(const float s, const Matrix4& A);
+	Vector4 operator*(const Matrix4& lhs, const Vector4& rhs);
+	Vector4 operator*(const Vector4& lhs, const Matrix4& rhs);
+	Matrix4 operator*(const Matrix4& lhs, const Matrix4& rhs);
+	std::ostream& operator <<(std::ostream& out, const Matrix4& A);
+
+	constexpr Matrix4::Matrix4()
+	: m{1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f}
+	{
+		// Nothing to do.
+	}
+
+	constexpr Matrix4::Matrix4(const float arr[16])
+	: m{arr[0], arr[1], arr[2], arr[3],
+		arr[4], arr[5], arr[6], arr[7],
+		arr[8], arr[9], arr[10], arr[11],
+		arr[12], arr[13], arr[14], arr[15]}
+	{
+		// Nothing to do.
+	}
+
+	constexpr Matrix4::Matrix4(float entry00, float entry01, float entry02, float entry03,
+		float entry10, float entry11, float entry12, float entry13,
+		float entry20, float entry21, float entry22, float entry23,
+		float entry30, float entry31, float entry32, float entry33)
+	: m{entry00, entry01, entry02, entry03,
+		entry10, entry11, entry12, entry13,
+		entry20, entry21, entry22, entry23,
+		entry30, entry31, entry32, entry33}
+	{
+		// Nothing to do.
+	}
+
+	constexpr Matrix4::Matrix4(const Matrix3& A)
+	: m{A[0], A[1], A[2], 0.0f,
+		A[3], A[4], A[5], 0.0f,
+		A[6], A[7], A[8], 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f}
+	{
+		// Nothing to do.
+	}
+
+	constexpr Matrix4::Matrix4(const Quaternion& q)
+	: m{1.0f - 2.0f * q.y * q.y - 2.0f * q.z * q.z,
+		2.0f * q.x * q.y - 2.0f * q.w * q.z,
+		2.0f * q.x * q.z + 2.0f * q.w * q.y,
+		0.0f,
+		2.0f * q.x * q.y + 2.0f * q.w * q.z,
+		1.0f - 2.0f * q.x * q.x - 2.0f * q.z * q.z,
+		2.0f * q.y * q.z - 2.0f * q.w * q.x,
+		0.0f,
+		2.0f * q.x * q.z - 2.0f * q.w * q.y,
+		2.0f * q.y * q.z + 2.0f * q.w * q.x,
+		1.0f - 2.0f * q.x * q.x - 2.0f * q.y * q.y,
+		0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f}
+	{
+		// Nothing to do.
+	}
+
+	constexpr Matrix4 Matrix4::IDENTITY = Matrix4();
+	constexpr Matrix4 Matrix4::ZERO = Matrix4(
+		0.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f
+	);
+
+	constexpr float Matrix4::operator[](std::size_t index) const
+	{
+		assert(index < 16);
+		return m[index];
+	}
+
+	constexpr const float* Matrix4::data() const
+	{
+		return m;
+	}
+
+	constexpr Matrix4 operator+(const Matrix4& A, const Matrix4& B)
+	{
+		return Matrix4(
+			A[0] + B[0], A[1] + B[1], A[2] + B[2], A[3] + B[3],
+			A[4] + B[4], A[5] + B[5], A[6] + B[6], A[7] + B[7],
+			A[8] + B[8], A[9] + B[9], A[10] + B[10], A[11] + B[11],
+			A[12] + B[12], A[13] + B[13], A[14] + B[14], A[15] + B[15]
+		);
+	}
+
+	constexpr Matrix4 operator-(const Matrix4& lhs, const Matrix4& rhs)
+	{
+		return Matrix4(
+			lhs[0] - rhs[0], lhs[1] - rhs[1], lhs[2] - rhs[2], lhs[3] - rhs[3],
+			lhs[4] - rhs[4], lhs[5] - rhs[5], lhs[6] - rhs[6], lhs[7] - rhs[7],
+			lhs[8] - rhs[8], lhs[9] - rhs[9], lhs[10] - rhs[10], lhs[11] - rhs[11],
+			lhs[12] - rhs[12], lhs[13] - rhs[13], lhs[14] - rhs[14], lhs[15] - rhs[15]
+		);
+	}
+
+	constexpr Matrix4 operator-(const Matrix4& A)
+	{
+		return Matrix4(
+			-A[0], -A[1], -A[2], -A[3],
+			-A[4], -A[5], -A[6], -A[7],
+			-A[8], -A[9], -A[10], -A[11],
+			-A[12], -A[13], -A[14], -A[15]
+		);
+	}
+
+	constexpr Matrix4 operator*(const Matrix4& A, const float s)
+	{
+		return Matrix4(
+			A[0] * s, A[1] * s, A[2] * s, A[3] * s,
+			A[4] * s, A[5] * s, A[6] * s, A[7] * s,
+			A[8] * s, A[9] * s, A[10] * s, A[11] * s,
+			A[12] * s, A[13] * s, A[14] * s, A[15] * s
+		);
+	}
+
+	constexpr Matrix4 operator*(const float s, const Matrix4& A)
+	{
+		return A * s;
+	}
+
+	inline Vector4 operator*(const Matrix4& lhs, const Vector4& rhs)
+	{
+		Vector4 result;
+		simd::multiplyMatrix4Vector4(lhs.data(), &rhs.x, &result.x);
+		return result;
+	}
+
+	inline Vector4 operator*(const Vector4& lhs, const Matrix4& rhs)
+	{
+		Vector4 result;
+		simd::multiplyVector4Matrix4(&lhs.x, rhs.data(), &result.x);
+		return result;
+	}
+
+	inline Matrix4 operator*(const Matrix4& lhs, const Matrix4& rhs)
+	{
+		float result[16];
+		simd::multiplyMatrix4(lhs.data(), rhs.data(), result);
+		return Matrix4(result);
+	}
+
+	constexpr Matrix4 Matrix4::transposed() const
+	{
+		return Matrix4(
+			m[0], m[4], m[8], m[12],
+			m[1], m[5], m[9], m[13],
+			m[2], m[6], m[10], m[14],
+			m[3], m[7], m[11], m[15]
+		);
+	}
+
+	inline void Matrix4::transpose()
+	{
+		std::swap(m[1], m[4]);
+		std::swap(m[2], m[8]);
+		std::swap(m[3], m[12]);
+		std::swap(m[6], m[9]);
+		std::swap(m[7], m[13]);
+		std::swap(m[11], m[14]);
+	}
+
+	constexpr float Matrix4::determinant() const
+	{
+		const float det1 = m[10] * (m[15] * m[5] - m[7] * m[13]) + m[11] * (m[13] * m[6] - m[5] * m[14]) + m[9] * (m[14] * m[7] - m[6] * m[15]);
+		const float det2 = m[1] * (m[10] * m[15] - m[11] * m[14]) + m[2] * (m[11] * m[13] - m[9] * m[15]) + m[3] * (m[9] * m[14] - m[10] * m[13]);
+		const float det3 = m[1] * (m[6] * m[15] - m[7] * m[14]) + m[2] * (m[7] * m[13] - m[5] * m[15]) + m[3] * (m[5] * m[14] - m[6] * m[13]);
+		const float det4 = m[1] * (m[6] * m[11] - m[7] * m[10]) + m[2] * (m[7] * m[9] - m[5] * m[11]) + m[3] * (m[5] * m[10] - m[6] * m[9]);
+
+		return (m[0] * det1 - m[4] * det2 + m[8] * det3 - m[12] * det4);
+	}
+
+	constexpr Matrix4 Matrix4::scaling(const Vector3& scaleFactors)
+	{
+		return Matrix4(
+			scaleFactors.x, 0.0f, 0.0f, 0.0f,
+			0.0f, scaleFactors.y, 0.0f, 0.0f,
+			0.0f, 0.0f, scaleFactors.z, 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f
+		);
+	}
+
+	constexpr Matrix4 Matrix4::scaling(const float factor)
+	{
+		return Matrix4(
+			factor, 0.0f, 0.0f, 0.0f,
+			0.0f, factor, 0.0f, 0.0f,
+			0.0f, 0.0f, factor, 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f
+		);
+	}
+
+	constexpr Matrix4 Matrix4::translation(const Vector3& translation)
+	{
+		return Matrix4(
+			1.0f, 0.0f, 0.0f, translation.x,
+			0.0f, 1.0f, 0.0f, translation.y,
+			0.0f, 0.0f, 1.0f, translation.z,
+			0.0f, 0.0f, 0.0f, 1.0f
+		);
+	}
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <M3D/Simd.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace M3D
+{
+	// Accuracy/speed trade-off for the functions taking a Precision template
+	// parameter: magnitude(), normalized(), normalize(), angle(),
+	// Quaternion::angleAxis(), Quaternion::euler(),
+	// Quaternion::rotateTowards() and ToEulerRad() in Unity.h.
+	//
+	// Exact is the default and goes through <cmath>. Fast uses the
+	// approximations in Math<Precision::Fast>, which are accurate enough for
+	// overlays and interpolation but should not be fed back into transforms
+	// that accumulate over many frames.
+	enum class Precision
+	{
+		Exact,
+		Fast
+	};
+
+	template <Precision P>
+	struct Math;
+
+	template <>
+	struct Math<Precision::Exact>
+	{
+		static float sqrt(const float x)
+		{
+			return std::sqrt(x);
+		}
+
+		static float rsqrt(const float x)
+		{
+			return 1.0f / std::sqrt(x);
+		}
+
+		static void sinCos(const float x, float& s, float& c)
+		{
+			s = std::sin(x);
+			c = std::cos(x);
+		}
+
+		static float sin(const float x)
+		{
+			return std::sin(x);
+		}
+
+		static float cos(const float x)
+		{
+			return std::cos(x);
+		}
+
+		static float acos(const float x)
+		{
+			return std::acos(x);
+		}
+
+		static float asin(const float x)
+		{
+			return std::asin(x);
+		}
+
+		static float atan2(const float y, const float x)
+		{
+			return std::atan2(y, x);
+		}
+	};
+
+	// Worst-case errors, measured against the double precision <cmath>
+	// functions over the whole float range of the argument unless noted:
+	//
+	//	rsqrt, sqrt   relative 3e-7 (SSE, NEON), 4.8e-6 (scalar fallback)
+	//	sin, cos      absolute 1.2e-6 for |x| <= 1e4
+	//	acos, asin    absolute 5.1e-6 on [-1, 1]
+	//	atan2         absolute 1.2e-5
+	//
+	// Errors compound in callers: angle() between nearly parallel vectors
+	// goes through acos close to 1, where a 5e-6 error in the cosine becomes
+	// about 6e-4 radians with the scalar rsqrt.
+	//
+	// rsqrt(0) is infinite and sqrt(0) is 0, as with Exact. sin and cos lose
+	// accuracy linearly beyond |x| = 1e4 since the argument reduction uses a
+	// three-part pi/2. Far beyond that the reduction breaks down and they
+	// may return values outside [-1, 1]; they are NaN for infinite or NaN x.
+	template <>
+	struct Math<Precision::Fast>
+	{
+		static float rsqrt(const float x)
+		{
+			// The Newton-Raphson step below turns the infinite estimate for
+			// 0 into 0 * inf = NaN on SSE, and the bit trick has no infinite
+			// estimate at all, so 0 is handled apart, as 1 / sqrt(+-0).
+			if (x == 0.0f)
+			{
+				return 1.0f / x;
+			}
+
+			// Hardware estimate (12 bits on SSE, 8 on NEON) or the integer
+			// bit trick (4 bits), refined by Newton-Raphson steps
+			// r' = r * (1.5 - 0.5 * x * r * r) up to about 22 bits.
+#if defined(M3D_SIMD_NEON)
+			float32x2_t v = vdup_n_f32(x);
+			float32x2_t r = vrsqrte_f32(v);
+			r = vmul_f32(vrsqrts_f32(vmul_f32(v, r), r), r);
+			r = vmul_f32(vrsqrts_f32(vmul_f32(v, r), r), r);
+			return vget_lane_f32(r, 0);
+#elif defined(M3D_SIMD_SSE)
+			const float r = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+			return r * (1.5f - 0.5f * x * r * r);
+#else
+			std::uint32_t bits;
+			std::memcpy(&bits, &x, sizeof(bits));
+			bits = 0x5f375a86u - (bits >> 1);
+			float r;
+			std::memcpy(&r, &bits, sizeof(r));
+			r = r * (1.5f - 0.5f * x * r * r);
+			return r * (1.5f - 0.5f * x * r * r);
+#endif
+		}
+
+		static float sqrt(const float x)
+		{
+			return x > 0.0f ? x * rsqrt(x) : 0.0f;
+		}
+
+		static void sinCos(const float x, float& s, float& c)
+		{
+			// Reduce to r in [-pi/4, pi/4] and the quadrant, with pi/2 split
+			// in three parts (Cody-Waite) so the first products are exact.
+			const float quadrant = std::floor(x * 0.636619772f + 0.5f);
+			const float r = ((x - quadrant * 1.5703125f) - quadrant * 4.83751297e-04f)
+				- quadrant * 7.54978995e-08f;
+			const float r2 = r * r;
+
+			// Minimax polynomials on [-pi/4, pi/4]. simd::sinCos uses the
+			// same constants.
+			const float sinR = r * (0.999998495f + r2 * (-0.166623861f + r2 * 0.00815013610f));
+			const float cosR = 0.999999972f + r2 * (-0.499998567f + r2 * (0.0416550260f + r2 * -0.00135858975f));
+
+			// quadrant mod 4, computed in float as simd::sinCos does, since
+			// converting quadrant itself overflows for large or NaN x. A NaN
+			// index only arises with a NaN r, so any case will do for it.
+			const float q = quadrant - 4.0f * std::floor(quadrant * 0.25f);
+			switch (q >= 0.0f && q < 4.0f ? static_cast<int>(q) : 0)
+			{
+			case 0: s = sinR; c = cosR; break;
+			case 1: s = cosR; c = -sinR; break;
+			case 2: s = -sinR; c = -cosR; break;
+			default: s = -cosR; c = sinR; break;
+			}
+		}
+
+		static float sin(const float x)
+		{
+			float s, c;
+			sinCos(x, s, c);
+			return s;
+		}
+
+		static float cos(const float x)
+		{
+			float s, c;
+			sinCos(x, s, c);
+			return c;
+		}
+
+		static float acos(const float x)
+		{
+			// acos(|x|) = sqrt(1 - |x|) * p(|x|) with p a quartic minimax
+			// fit, reflected for negative x.
+			const float a = std::fabs(x);
+			const float p = 1.57079154f + a * (-0.214280698f + a * (0.0856387548f
+				+ a * (-0.0376188039f + a * 0.00973326769f)));
+			const float result = std::sqrt(1.0f - a) * p;
+			return x < 0.0f ? 3.14159265f - result : result;
+		}
+
+		static float asin(const float x)
+		{
+			return 1.57079633f - acos(x);
+		}
+
+		static float atan2(const float y, const float x)
+		{
+			// atan of the smaller over the larger magnitude, which is in
+			// [0, 1], then moved to the right octant.
+			const float ax = std::fabs(x);
+			const float ay = std::fabs(y);
+			const float larger = ax > ay ? ax : ay;
+			if (larger == 0.0f)
+			{
+				return 0.0f;
+			}
+
+			const float t = (ax > ay ? ay : ax) / larger;
+			const float t2 = t * t;
+			float result = t * (0.999866551f + t2 * (-0.330308506f + t2 * (0.180175445f
+				+ t2 * (-0.0851815626f + t2 * 0.0208579542f))));
+
+			if (ay > ax) result = 1.57079633f - result;
+			if (x < 0.0f) result = 3.14159265f - result;
+			return y < 0.0f ? -result : result;
+		}
+	};
+}
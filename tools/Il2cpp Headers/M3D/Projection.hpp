@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct Rect;
+
+namespace M3D
+{
+	class Matrix4;
+	class UnityMatrix4;
+	class Vector2;
+	class Vector3;
+
+	// Bits of the flags written by project(). A point with no bit set is
+	// inside the viewport and between the near and far planes.
+	struct ProjectionFlags
+	{
+		// w <= 0 in clip space: the point is behind the camera (or on its
+		// plane). Its screen position is meaningless and the other bits
+		// are not set.
+		static const std::uint8_t BEHIND_CAMERA = 1;
+
+		// Left of, right of, above or below the viewport.
+		static const std::uint8_t OUTSIDE_VIEWPORT = 2;
+
+		// Closer than the near plane or further than the far plane.
+		static const std::uint8_t DEPTH_CLIPPED = 4;
+	};
+
+	// Where screen coordinates start.
+	enum class ScreenOrigin
+	{
+		// y grows upwards from the bottom of the viewport, as
+		// Camera.WorldToScreenPoint() returns it.
+		BottomLeft,
+
+		// y grows downwards from the top, as most drawing APIs expect.
+		TopLeft
+	};
+
+	// Projects count world positions through viewProjection (projection *
+	// view, for column vectors, with OpenGL clip space -w <= x, y, z <= w as
+	// Unity's Camera.projectionMatrix uses) into the pixel rectangle
+	// viewport. Writes, for each position:
+	//
+	//	screen[i]  pixel position.
+	//	depth[i]   clip space w, which for a perspective projection is the
+	//	           distance in front of the camera along its forward axis,
+	//	           the z of Camera.WorldToScreenPoint().
+	//	flags[i]   ProjectionFlags bits.
+	//
+	// Returns the number of positions with no flag set. The perspective
+	// divide and all the tests run four positions at a time.
+	std::size_t project(const Matrix4& viewProjection, const Vector3* positions, std::size_t count,
+		const Rect& viewport, Vector2* screen, float* depth, std::uint8_t* flags,
+		ScreenOrigin origin = ScreenOrigin::BottomLeft);
+
+	// As above, for a matrix read in place from a Unity Matrix4x4.
+	std::size_t project(const UnityMatrix4& viewProjection, const Vector3* positions, std::size_t count,
+		const Rect& viewport, Vector2* screen, float* depth, std::uint8_t* flags,
+		ScreenOrigin origin = ScreenOrigin::BottomLeft);
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <M3D/Precision.hpp>
+#include <M3D/Vector3.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <ostream>
+
+namespace M3D
+{
+	// A rotation stored as w + xi + yj + zk.
+	class Quaternion
+	{
+	public:
+		float w;
+		float x;
+		float y;
+		float z;
+
+		static const Quaternion IDENTITY;
+
+		constexpr Quaternion();
+		constexpr Quaternion(float w_, float x_, float y_, float z_);
+		constexpr Quaternion(const float s, const Vector3& v);
+
+		constexpr float sqrMagnitude() const;
+		template <Precision P = Precision::Exact> float magnitude() const;
+		template <Precision P = Precision::Exact> Quaternion normalized() const;
+		template <Precision P = Precision::Exact> void normalize();
+
+		// Rotates this quaternion towards target by at most maxRadiansDelta.
+		template <Precision P = Precision::Exact>
+		void rotateTowards(const Quaternion& target, float maxRadiansDelta);
+
+		constexpr Quaternion conjugate() const;
+		constexpr Quaternion inverse() const;
+
+		// Rotation of angle radians about the unit vector axis.
+		template <Precision P = Precision::Exact>
+		static Quaternion angleAxis(const float angle, const Vector3& axis);
+
+		// Rotation from XYZ Euler angles in radians.
+		template <Precision P = Precision::Exact>
+		static Quaternion euler(const Vector3& eulerAngles);
+
+		static Quaternion fromToRotation(const Vector3& fromDirection, const Vector3& toDirection);
+		static Quaternion lookRotation(const Vector3& forward);
+		static Quaternion lookRotation(const Vector3& forward, const Vector3& upwards);
+	};
+
+	float operator==(const Quaternion& q1, const Quaternion& q2);
+	float operator!=(const Quaternion& q1, const Quaternion& q2);
+	constexpr Quaternion operator*(const Quaternion& lhs, const Quaternion& rhs);
+	constexpr Vector3 operator*(const Quaternion& q, const Vector3& v);
+	std::ostream& operator <<(std::ostream& out, const Quaternion& q);
+
+	constexpr float dot(const Quaternion& lhs, const Quaternion& rhs);
+	template <Precision P = Precision::Exact>
+	float angle(const Quaternion& from, const Quaternion& to);
+
+	// Interpolation between the unit quaternions from (t = 0) and to
+	// (t = 1), along the shorter arc: to is negated first when the two are
+	// more than 180 degrees apart. t is not clamped, and the result is
+	// normalized.
+	//
+	// slerp turns at constant angular speed. nlerp normalizes the linear
+	// interpolation, which is cheaper and follows the same path, but
+	// speeds up towards the middle; below about 30 degrees apart the two
+	// differ by less than 0.1 degree. When from and to are within 3.6
+	// degrees of each other, slerp replaces the sines of its weights with
+	// their series, which is as accurate there and skips the trigonometry.
+
+	template <Precision P = Precision::Exact>
+	Quaternion slerp(const Quaternion& from, const Quaternion& to, float t);
+	template <Precision P = Precision::Exact>
+	Quaternion nlerp(const Quaternion& from, const Quaternion& to, float t);
+
+	constexpr Quaternion::Quaternion()
+	: w(1.0f)
+	, x(0.0f)
+	, y(0.0f)
+	, z(0.0f)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Quaternion::Quaternion(float w_, float x_, float y_, float z_)
+	: w(w_)
+	, x(x_)
+	, y(y_)
+	, z(z_)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Quaternion::Quaternion(const float s, const Vector3& v)
+	: w(s)
+	, x(v.x)
+	, y(v.y)
+	, z(v.z)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Quaternion Quaternion::IDENTITY = Quaternion(1.0f, 0.0f, 0.0f, 0.0f);
+
+	constexpr Quaternion operator*(const Quaternion& lhs, const Quaternion& rhs)
+	{
+		return Quaternion(
+			lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z,
+			lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+			lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
+			lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w
+		);
+	}
+
+	constexpr Vector3 operator*(const Quaternion& q, const Vector3& v)
+	{
+		// Quaternion r = q * Quaternion(0.0f, v.x, v.y, v.z) * q.conjugate();
+		// return Vector3(r.x, r.y, r.z);
+
+		// This faster method is described:
+		// http://molecularmusings.wordpress.com/2013/05/24/a-faster-quaternion-vector-multiplication/
+		const Vector3 qv = Vector3(q.x, q.y, q.z);
+		const Vector3 t = 2.0f * cross(qv, v);
+		return v + q.w * t + cross(qv, t);
+	}
+
+	constexpr float Quaternion::sqrMagnitude() const
+	{
+		return w * w + x * x + y * y + z * z;
+	}
+
+	template <Precision P>
+	inline float Quaternion::magnitude() const
+	{
+		return Math<P>::sqrt(sqrMagnitude());
+	}
+
+	template <Precision P>
+	inline Quaternion Quaternion::normalized() const
+	{
+		assert(sqrMagnitude() > 0.0f);
+		const float invNorm = Math<P>::rsqrt(sqrMagnitude());
+
+		return Quaternion(w * invNorm, x * invNorm, y * invNorm, z * invNorm);
+	}
+
+	template <Precision P>
+	inline void Quaternion::normalize()
+	{
+		assert(sqrMagnitude() > 0.0f);
+		const float invNorm = Math<P>::rsqrt(sqrMagnitude());
+
+		w *= invNorm;
+		x *= invNorm;
+		y *= invNorm;
+		z *= invNorm;
+	}
+
+	constexpr Quaternion Quaternion::conjugate() const
+	{
+		return Quaternion(w, -x, -y, -z);
+	}
+
+	constexpr Quaternion Quaternion::inverse() const
+	{
+		const float sqr = sqrMagnitude();
+		assert(sqr > 0.0f);
+
+		const float invSqr = 1.0f / sqr;
+		return Quaternion(w * invSqr, -x * invSqr, -y * invSqr, -z * invSqr);
+	}
+
+	constexpr float dot(const Quaternion& lhs, const Quaternion& rhs)
+	{
+		return lhs.w * rhs.w + lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
+	}
+}
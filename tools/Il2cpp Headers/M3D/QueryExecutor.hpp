@@ -0,0 +1,82 @@
+#pragma once
+
+#include <M3D/SpatialGrid.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace M3D
+{
+	class ThreadPool;
+	class Vector3;
+
+	// Results of a batch of queries: those of query i are items[offsets[i]]
+	// to items[offsets[i + 1]], in the order the single query returns them.
+	template <typename T>
+	struct QueryResults
+	{
+		std::vector<std::size_t> offsets;
+		std::vector<T> items;
+
+		// Number of queries.
+		std::size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+		const T* begin(std::size_t query) const { return items.data() + offsets[query]; }
+		const T* end(std::size_t query) const { return items.data() + offsets[query + 1]; }
+		std::size_t count(std::size_t query) const { return offsets[query + 1] - offsets[query]; }
+	};
+
+	// Runs batches of SpatialGrid queries over a ThreadPool. Each worker
+	// appends to a buffer of its own, and the buffers are then copied into
+	// the results in query order, so the results are the same whatever the
+	// number of threads and however the queries were shared among them.
+	//
+	// The buffers are kept between batches, so running a batch of the same
+	// size every frame allocates nothing once warm. An executor may run one
+	// batch at a time; the grid must not change while it does.
+	class QueryExecutor
+	{
+	public:
+		// grain is the number of queries a worker takes at a time.
+		explicit QueryExecutor(ThreadPool& pool, std::size_t grain = 64);
+
+		// SpatialGrid::queryRadius() at each of count centers, with a radius
+		// each or the same radius for all.
+		void queryRadius(const SpatialGrid& grid, const Vector3* centers, const float* radii, std::size_t count,
+			QueryResults<std::uint32_t>& out);
+		void queryRadius(const SpatialGrid& grid, const Vector3* centers, float radius, std::size_t count,
+			QueryResults<std::uint32_t>& out);
+
+		// SpatialGrid::queryBox() for each of count boxes [min[i], max[i]].
+		void queryBox(const SpatialGrid& grid, const Vector3* min, const Vector3* max, std::size_t count,
+			QueryResults<std::uint32_t>& out);
+
+		// SpatialGrid::queryNearest() at each of count points.
+		void queryNearest(const SpatialGrid& grid, const Vector3* points, std::size_t count, std::size_t k,
+			QueryResults<SpatialGrid::Neighbor>& out, float maxDistance = std::numeric_limits<float>::infinity());
+
+		// SpatialGrid::nearest() at each of count points, into nearest.
+		void nearest(const SpatialGrid& grid, const Vector3* points, std::size_t count, std::uint32_t* nearest,
+			float maxDistance = std::numeric_limits<float>::infinity());
+
+	private:
+		// Runs query(i, buffer, worker) for each query, query appending its
+		// results to buffer, the buffer of worker, and gathers the buffers
+		// into out.
+		template <typename T, typename Query>
+		void run(std::size_t count, QueryResults<T>& out, std::vector<std::vector<T>>& buffers, Query query);
+
+		ThreadPool& pool;
+		std::size_t grain;
+
+		// Per worker results, and where the results of each query start in
+		// its worker's buffer.
+		std::vector<std::vector<std::uint32_t>> indexBuffers;
+		std::vector<std::vector<SpatialGrid::Neighbor>> neighborBuffers;
+		std::vector<std::vector<SpatialGrid::Neighbor>> neighborScratch;
+		std::vector<std::size_t> starts;
+		std::vector<unsigned int> owners;
+	};
+}
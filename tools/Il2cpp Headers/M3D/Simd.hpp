@@ -0,0 +1,664 @@
+#pragma once
+
+// Picks the vector instruction set used by the M3D kernels at compile time.
+// NEON is used on ARM (Android), SSE (and AVX/FMA when enabled) on x86.
+// Define M3D_NO_SIMD before including any M3D header to force the portable
+// scalar fallback, e.g. to compare results against the vectorized paths.
+#if !defined(M3D_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+	#define M3D_SIMD_NEON 1
+	#include <arm_neon.h>
+#elif !defined(M3D_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+	#define M3D_SIMD_SSE 1
+	#include <xmmintrin.h>
+	#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define M3D_SIMD_SSE2 1
+		#include <emmintrin.h>
+	#endif
+	#if defined(__SSE4_1__)
+		#include <smmintrin.h>
+	#endif
+	#if defined(__AVX__) || defined(__FMA__)
+		#include <immintrin.h>
+	#endif
+	#if defined(__AVX__)
+		#define M3D_SIMD_AVX 1
+	#endif
+#else
+	#define M3D_SIMD_SCALAR 1
+#endif
+
+// __builtin_shufflevector gives arbitrary two-register lane permutes on
+// NEON (clang, which the NDK uses, and GCC 12+).
+#if defined(__has_builtin)
+	#if __has_builtin(__builtin_shufflevector)
+		#define M3D_SIMD_HAS_SHUFFLEVECTOR 1
+	#endif
+#endif
+
+#include <cmath>
+
+namespace M3D
+{
+	namespace simd
+	{
+#if defined(M3D_SIMD_NEON)
+		typedef float32x4_t float4;
+		typedef uint32x4_t mask4;
+#elif defined(M3D_SIMD_SSE)
+		typedef __m128 float4;
+		typedef __m128 mask4;
+#else
+		struct float4
+		{
+			float v[4];
+		};
+
+		struct mask4
+		{
+			bool v[4];
+		};
+#endif
+
+		// Number of floats held by one float4 register.
+		const unsigned int WIDTH = 4;
+
+		// Loads four floats. The pointer does not need to be aligned.
+		inline float4 load(const float* p)
+		{
+#if defined(M3D_SIMD_NEON)
+			return vld1q_f32(p);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_loadu_ps(p);
+#else
+			return float4{{p[0], p[1], p[2], p[3]}};
+#endif
+		}
+
+		// Stores four floats. The pointer does not need to be aligned.
+		inline void store(float* p, const float4 a)
+		{
+#if defined(M3D_SIMD_NEON)
+			vst1q_f32(p, a);
+#elif defined(M3D_SIMD_SSE)
+			_mm_storeu_ps(p, a);
+#else
+			p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3];
+#endif
+		}
+
+		// Broadcasts a scalar into all four lanes.
+		inline float4 splat(const float s)
+		{
+#if defined(M3D_SIMD_NEON)
+			return vdupq_n_f32(s);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_set1_ps(s);
+#else
+			return float4{{s, s, s, s}};
+#endif
+		}
+
+		inline float4 add(const float4 a, const float4 b)
+		{
+#if defined(M3D_SIMD_NEON)
+			return vaddq_f32(a, b);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_add_ps(a, b);
+#else
+			return float4{{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+#endif
+		}
+
+		inline float4 sub(const float4 a, const float4 b)
+		{
+#if defined(M3D_SIMD_NEON)
+			return vsubq_f32(a, b);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_sub_ps(a, b);
+#else
+			return float4{{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+#endif
+		}
+
+		inline float4 mul(const float4 a, const float4 b)
+		{
+#if defined(M3D_SIMD_NEON)
+			return vmulq_f32(a, b);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_mul_ps(a, b);
+#else
+			return float4{{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+#endif
+		}
+
+		// Returns a * b + c, fused into a single instruction where the target
+		// supports it.
+		inline float4 madd(const float4 a, const float4 b, const float4 c)
+		{
+#if defined(M3D_SIMD_NEON) && defined(__aarch64__)
+			return vfmaq_f32(c, a, b);
+#elif defined(M3D_SIMD_NEON)
+			return vmlaq_f32(c, a, b);
+#elif defined(M3D_SIMD_SSE) && defined(__FMA__)
+			return _mm_fmadd_ps(a, b, c);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_add_ps(_mm_mul_ps(a, b), c);
+#else
+			return add(mul(a, b), c);
+#endif
+		}
+
+		inline float4 div(const float4 a, const float4 b)
+		{
+#if defined(M3D_SIMD_NEON) && defined(__aarch64__)
+			return vdivq_f32(a, b);
+#elif defined(M3D_SIMD_NEON)
+			// ARMv7 has no vector divide: refine the reciprocal estimate with
+			// two Newton-Raphson steps, which is accurate to about 1 ulp.
+			float32x4_t r = vrecpeq_f32(b);
+			r = vmulq_f32(vrecpsq_f32(b, r), r);
+			r = vmulq_f32(vrecpsq_f32(b, r), r);
+			return vmulq_f32(a, r);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_div_ps(a, b);
+#else
+			return float4{{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}};
+#endif
+		}
+
+		// Per lane minimum. Where either lane is NaN the result is
+		// unspecified.
+		inline float4 min(const float4 a, const float4 b)
+		{
+#if defined(M3D_SIMD_NEON)
+			return vminq_f32(a, b);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_min_ps(a, b);
+#else
+			return float4{{a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1],
+				a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3]}};
+#endif
+		}
+
+		// Per lane maximum. Where either lane is NaN the result is
+		// unspecified.
+		inline float4 max(const float4 a, const float4 b)
+		{
+#if defined(M3D_SIMD_NEON)
+			return vmaxq_f32(a, b);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_max_ps(a, b);
+#else
+			return float4{{a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1],
+				a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3]}};
+#endif
+		}
+
+		inline float4 abs(const float4 a)
+		{
+#if defined(M3D_SIMD_NEON)
+			return vabsq_f32(a);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_andnot_ps(_mm_set1_ps(-0.0f), a);
+#else
+			return float4{{std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]), std::fabs(a.v[3])}};
+#endif
+		}
+
+		inline mask4 greaterThan(const float4 a, const float4 b)
+		{
+#if defined(M3D_SIMD_NEON)
+			return vcgtq_f32(a, b);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_cmpgt_ps(a, b);
+#else
+			return mask4{{a.v[0] > b.v[0], a.v[1] > b.v[1], a.v[2] > b.v[2], a.v[3] > b.v[3]}};
+#endif
+		}
+
+		// Per lane: mask ? a : b.
+		inline float4 select(const mask4 mask, const float4 a, const float4 b)
+		{
+#if defined(M3D_SIMD_NEON)
+			return vbslq_f32(mask, a, b);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+#else
+			return float4{{mask.v[0] ? a.v[0] : b.v[0], mask.v[1] ? a.v[1] : b.v[1],
+				mask.v[2] ? a.v[2] : b.v[2], mask.v[3] ? a.v[3] : b.v[3]}};
+#endif
+		}
+
+		// Packs the mask into the low four bits of an integer, lane 0 first.
+		inline unsigned int moveMask(const mask4 mask)
+		{
+#if defined(M3D_SIMD_NEON)
+			const uint32_t bits[4] = {1, 2, 4, 8};
+			const uint32x4_t weighted = vandq_u32(mask, vld1q_u32(bits));
+	#if defined(__aarch64__)
+			return vaddvq_u32(weighted);
+	#else
+			const uint32x2_t sum = vpadd_u32(vget_low_u32(weighted), vget_high_u32(weighted));
+			return vget_lane_u32(vpadd_u32(sum, sum), 0);
+	#endif
+#elif defined(M3D_SIMD_SSE)
+			return static_cast<unsigned int>(_mm_movemask_ps(mask));
+#else
+			return (mask.v[0] ? 1u : 0u) | (mask.v[1] ? 2u : 0u) | (mask.v[2] ? 4u : 0u) | (mask.v[3] ? 8u : 0u);
+#endif
+		}
+
+		inline float4 sqrt(const float4 a)
+		{
+#if defined(M3D_SIMD_NEON) && defined(__aarch64__)
+			return vsqrtq_f32(a);
+#elif defined(M3D_SIMD_NEON)
+			// sqrt(a) = a * rsqrt(a), with the estimate refined twice. Zero
+			// lanes are handled separately since rsqrt(0) is infinite.
+			float32x4_t r = vrsqrteq_f32(a);
+			r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+			r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+			return vbslq_f32(vcgtq_f32(a, vdupq_n_f32(0.0f)), vmulq_f32(a, r), a);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_sqrt_ps(a);
+#else
+			return float4{{std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])}};
+#endif
+		}
+
+		// Rounds each lane towards negative infinity. Lanes must fit in an
+		// int32.
+		inline float4 floor(const float4 a)
+		{
+#if defined(M3D_SIMD_NEON) && defined(__aarch64__)
+			return vrndmq_f32(a);
+#elif defined(M3D_SIMD_NEON)
+			const float32x4_t t = vcvtq_f32_s32(vcvtq_s32_f32(a));
+			return vsubq_f32(t, vbslq_f32(vcgtq_f32(t, a), vdupq_n_f32(1.0f), vdupq_n_f32(0.0f)));
+#elif defined(M3D_SIMD_SSE) && defined(__SSE4_1__)
+			return _mm_floor_ps(a);
+#elif defined(M3D_SIMD_SSE2)
+			// Truncate, then step down the lanes that were rounded up.
+			const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+			return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+#elif defined(M3D_SIMD_SSE)
+			float v[4];
+			_mm_storeu_ps(v, a);
+			return _mm_setr_ps(std::floor(v[0]), std::floor(v[1]), std::floor(v[2]), std::floor(v[3]));
+#else
+			return float4{{std::floor(a.v[0]), std::floor(a.v[1]), std::floor(a.v[2]), std::floor(a.v[3])}};
+#endif
+		}
+
+		// Sine and cosine of each lane. Same argument reduction and
+		// polynomials as Math<Precision::Fast>::sinCos in M3D/Precision.hpp,
+		// so the same error bound: 1.2e-6 absolute for |x| <= 1e4.
+		inline void sinCos(const float4 x, float4& s, float4& c)
+		{
+			const float4 quadrant = floor(madd(x, splat(0.636619772f), splat(0.5f)));
+			float4 r = madd(quadrant, splat(-1.5703125f), x);
+			r = madd(quadrant, splat(-4.83751297e-04f), r);
+			r = madd(quadrant, splat(-7.54978995e-08f), r);
+			const float4 r2 = mul(r, r);
+
+			const float4 sinR = mul(r, madd(r2, madd(r2, splat(0.00815013610f), splat(-0.166623861f)),
+				splat(0.999998495f)));
+			const float4 cosR = madd(r2, madd(r2, madd(r2, splat(-0.00135858975f), splat(0.0416550260f)),
+				splat(-0.499998567f)), splat(0.999999972f));
+
+			// quadrant mod 4, in {0, 1, 2, 3}. Odd quadrants swap sin and cos,
+			// quadrants 2 and 3 negate the sine and 1 and 2 the cosine.
+			const float4 q = sub(quadrant, mul(splat(4.0f), floor(mul(quadrant, splat(0.25f)))));
+			const mask4 odd = greaterThan(sub(q, mul(splat(2.0f), floor(mul(q, splat(0.5f))))), splat(0.5f));
+			const float4 t = sub(q, splat(1.5f));
+			const float4 one = splat(1.0f);
+			const float4 minusOne = splat(-1.0f);
+
+			s = mul(select(odd, cosR, sinR), select(greaterThan(q, splat(1.5f)), minusOne, one));
+			c = mul(select(odd, sinR, cosR), select(greaterThan(one, mul(t, t)), minusOne, one));
+		}
+
+		// Arc cosine of each lane in [-1, 1]. Same polynomial as
+		// Math<Precision::Fast>::acos, so 5.1e-6 absolute.
+		inline float4 acos(const float4 x)
+		{
+			const float4 a = abs(x);
+			const float4 p = madd(a, madd(a, madd(a, madd(a, splat(0.00973326769f), splat(-0.0376188039f)),
+				splat(0.0856387548f)), splat(-0.214280698f)), splat(1.57079154f));
+			const float4 result = mul(sqrt(sub(splat(1.0f), a)), p);
+			return select(greaterThan(splat(0.0f), x), sub(splat(3.14159265f), result), result);
+		}
+
+		// Arc sine of each lane in [-1, 1], as Math<Precision::Fast>::asin.
+		inline float4 asin(const float4 x)
+		{
+			return sub(splat(1.57079633f), acos(x));
+		}
+
+		// Four quadrant arc tangent of y / x, 0 where both are 0. Same
+		// polynomial as Math<Precision::Fast>::atan2, so 1.2e-5 absolute.
+		inline float4 atan2(const float4 y, const float4 x)
+		{
+			const float4 zero = splat(0.0f);
+			const float4 ax = abs(x);
+			const float4 ay = abs(y);
+			const float4 larger = max(ax, ay);
+			const mask4 defined = greaterThan(larger, zero);
+			const float4 t = select(defined, div(min(ax, ay), select(defined, larger, splat(1.0f))), zero);
+			const float4 t2 = mul(t, t);
+			float4 result = mul(t, madd(t2, madd(t2, madd(t2, madd(t2, splat(0.0208579542f), splat(-0.0851815626f)),
+				splat(0.180175445f)), splat(-0.330308506f)), splat(0.999866551f)));
+
+			result = select(greaterThan(ay, ax), sub(splat(1.57079633f), result), result);
+			result = select(greaterThan(zero, x), sub(splat(3.14159265f), result), result);
+			return select(defined, select(greaterThan(zero, y), sub(zero, result), result), zero);
+		}
+
+		// Returns (a[X], a[Y], b[Z], b[W]).
+		template <int X, int Y, int Z, int W>
+		inline float4 shuffle(const float4 a, const float4 b)
+		{
+#if defined(M3D_SIMD_NEON) && defined(M3D_SIMD_HAS_SHUFFLEVECTOR)
+			return __builtin_shufflevector(a, b, X, Y, Z + 4, W + 4);
+#elif defined(M3D_SIMD_NEON)
+			float32x4_t r = vdupq_n_f32(vgetq_lane_f32(a, X));
+			r = vsetq_lane_f32(vgetq_lane_f32(a, Y), r, 1);
+			r = vsetq_lane_f32(vgetq_lane_f32(b, Z), r, 2);
+			return vsetq_lane_f32(vgetq_lane_f32(b, W), r, 3);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+#else
+			return float4{{a.v[X], a.v[Y], b.v[Z], b.v[W]}};
+#endif
+		}
+
+		// Returns the sum of the four lanes, broadcast to all of them.
+		inline float4 horizontalSum(const float4 a)
+		{
+			const float4 t = add(a, shuffle<1, 0, 3, 2>(a, a));
+			return add(t, shuffle<2, 3, 0, 1>(t, t));
+		}
+
+		// Returns lane 0.
+		inline float first(const float4 a)
+		{
+#if defined(M3D_SIMD_NEON)
+			return vgetq_lane_f32(a, 0);
+#elif defined(M3D_SIMD_SSE)
+			return _mm_cvtss_f32(a);
+#else
+			return a.v[0];
+#endif
+		}
+
+		// Transposes the 4x4 block held in the rows r0..r3 in place.
+		inline void transpose(float4& r0, float4& r1, float4& r2, float4& r3)
+		{
+#if defined(M3D_SIMD_NEON)
+			const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+			const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+			r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+			r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+			r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+			r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+#elif defined(M3D_SIMD_SSE)
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+#else
+			const float4 a = r0, b = r1, c = r2, d = r3;
+			r0 = float4{{a.v[0], b.v[0], c.v[0], d.v[0]}};
+			r1 = float4{{a.v[1], b.v[1], c.v[1], d.v[1]}};
+			r2 = float4{{a.v[2], b.v[2], c.v[2], d.v[2]}};
+			r3 = float4{{a.v[3], b.v[3], c.v[3], d.v[3]}};
+#endif
+		}
+
+		// Loads four packed xyz triples (12 floats) and splits them into one
+		// register per component.
+		inline void loadInterleaved3(const float* p, float4& x, float4& y, float4& z)
+		{
+#if defined(M3D_SIMD_NEON)
+			const float32x4x3_t v = vld3q_f32(p);
+			x = v.val[0];
+			y = v.val[1];
+			z = v.val[2];
+#elif defined(M3D_SIMD_SSE)
+			const __m128 a = _mm_loadu_ps(p + 0); // x0 y0 z0 x1
+			const __m128 b = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+			const __m128 c = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+			const __m128 t0 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+			const __m128 t1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+			x = _mm_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));
+			y = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));
+			z = _mm_shuffle_ps(t1, c, _MM_SHUFFLE(3, 0, 3, 1));
+#else
+			x = float4{{p[0], p[3], p[6], p[9]}};
+			y = float4{{p[1], p[4], p[7], p[10]}};
+			z = float4{{p[2], p[5], p[8], p[11]}};
+#endif
+		}
+
+		// Inverse of loadInterleaved3: writes four packed xyz triples.
+		inline void storeInterleaved3(float* p, const float4 x, const float4 y, const float4 z)
+		{
+#if defined(M3D_SIMD_NEON)
+			float32x4x3_t v;
+			v.val[0] = x;
+			v.val[1] = y;
+			v.val[2] = z;
+			vst3q_f32(p, v);
+#elif defined(M3D_SIMD_SSE)
+			const __m128 xyLow = _mm_unpacklo_ps(x, y); // x0 y0 x1 y1
+			const __m128 xyHigh = _mm_unpackhi_ps(x, y); // x2 y2 x3 y3
+			const __m128 t0 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)); // z0 z0 x1 x1
+			const __m128 t1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)); // y1 y1 z1 z1
+			const __m128 t2 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)); // z2 z2 x3 x3
+			const __m128 t3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)); // y3 y3 z3 z3
+			_mm_storeu_ps(p + 0, _mm_shuffle_ps(xyLow, t0, _MM_SHUFFLE(2, 0, 1, 0)));
+			_mm_storeu_ps(p + 4, _mm_shuffle_ps(t1, xyHigh, _MM_SHUFFLE(1, 0, 2, 0)));
+			_mm_storeu_ps(p + 8, _mm_shuffle_ps(t2, t3, _MM_SHUFFLE(2, 0, 2, 0)));
+#else
+			for (unsigned int i = 0; i < 4; ++i)
+			{
+				p[3 * i + 0] = x.v[i];
+				p[3 * i + 1] = y.v[i];
+				p[3 * i + 2] = z.v[i];
+			}
+#endif
+		}
+
+		// Writes four packed xy pairs (8 floats).
+		inline void storeInterleaved2(float* p, const float4 x, const float4 y)
+		{
+#if defined(M3D_SIMD_NEON)
+			float32x4x2_t v;
+			v.val[0] = x;
+			v.val[1] = y;
+			vst2q_f32(p, v);
+#elif defined(M3D_SIMD_SSE)
+			_mm_storeu_ps(p + 0, _mm_unpacklo_ps(x, y)); // x0 y0 x1 y1
+			_mm_storeu_ps(p + 4, _mm_unpackhi_ps(x, y)); // x2 y2 x3 y3
+#else
+			for (unsigned int i = 0; i < 4; ++i)
+			{
+				p[2 * i + 0] = x.v[i];
+				p[2 * i + 1] = y.v[i];
+			}
+#endif
+		}
+
+		// out = lhs * rhs for row-major 4x4 matrices. out may alias neither
+		// input.
+		inline void multiplyMatrix4(const float* lhs, const float* rhs, float* out)
+		{
+#if defined(M3D_SIMD_AVX)
+			// Each 256-bit register holds two rows of the result. The rows of
+			// rhs are duplicated into both halves and the matching entries of
+			// lhs are broadcast within each half.
+			const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 0));
+			const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 4));
+			const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 8));
+			const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(rhs + 12));
+
+			for (unsigned int i = 0; i < 16; i += 8)
+			{
+				const __m256 a = _mm256_loadu_ps(lhs + i);
+				__m256 r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), b0);
+	#if defined(__FMA__)
+				r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0x55), b1, r);
+				r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0xAA), b2, r);
+				r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, 0xFF), b3, r);
+	#else
+				r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x55), b1));
+				r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xAA), b2));
+				r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xFF), b3));
+	#endif
+				_mm256_storeu_ps(out + i, r);
+			}
+#else
+			// Row i of the result is the combination of the rows of rhs
+			// weighted by the entries of row i of lhs.
+			const float4 b0 = load(rhs + 0);
+			const float4 b1 = load(rhs + 4);
+			const float4 b2 = load(rhs + 8);
+			const float4 b3 = load(rhs + 12);
+
+			for (unsigned int i = 0; i < 16; i += 4)
+			{
+				float4 r = mul(splat(lhs[i]), b0);
+				r = madd(splat(lhs[i + 1]), b1, r);
+				r = madd(splat(lhs[i + 2]), b2, r);
+				r = madd(splat(lhs[i + 3]), b3, r);
+				store(out + i, r);
+			}
+#endif
+		}
+
+		// out = m * v for a row-major 4x4 matrix and a column vector.
+		inline void multiplyMatrix4Vector4(const float* m, const float* v, float* out)
+		{
+			// Work on the columns of m so that the result is a weighted sum of
+			// registers rather than four horizontal dot products.
+			float4 c0 = load(m + 0);
+			float4 c1 = load(m + 4);
+			float4 c2 = load(m + 8);
+			float4 c3 = load(m + 12);
+			transpose(c0, c1, c2, c3);
+
+			float4 r = mul(c0, splat(v[0]));
+			r = madd(c1, splat(v[1]), r);
+			r = madd(c2, splat(v[2]), r);
+			r = madd(c3, splat(v[3]), r);
+			store(out, r);
+		}
+
+		// out = v * m for a row vector and a row-major 4x4 matrix.
+		inline void multiplyVector4Matrix4(const float* v, const float* m, float* out)
+		{
+			float4 r = mul(splat(v[0]), load(m + 0));
+			r = madd(splat(v[1]), load(m + 4), r);
+			r = madd(splat(v[2]), load(m + 8), r);
+			r = madd(splat(v[3]), load(m + 12), r);
+			store(out, r);
+		}
+
+		// Rotates the four vectors (x, y, z) by the four quaternions
+		// (qw, qx, qy, qz) in place, lane by lane. Same formulation as
+		// operator*(const Quaternion&, const Vector3&):
+		// t = 2 * cross(q.xyz, v), v' = v + q.w * t + cross(q.xyz, t).
+		inline void rotateVector3(const float4 qw, const float4 qx, const float4 qy, const float4 qz,
+			float4& x, float4& y, float4& z)
+		{
+			const float4 two = splat(2.0f);
+			const float4 tx = mul(two, sub(mul(qy, z), mul(qz, y)));
+			const float4 ty = mul(two, sub(mul(qz, x), mul(qx, z)));
+			const float4 tz = mul(two, sub(mul(qx, y), mul(qy, x)));
+
+			x = add(madd(qw, tx, x), sub(mul(qy, tz), mul(qz, ty)));
+			y = add(madd(qw, ty, y), sub(mul(qz, tx), mul(qx, tz)));
+			z = add(madd(qw, tz, z), sub(mul(qx, ty), mul(qy, tx)));
+		}
+
+		// 2x2 matrix helpers for inverseMatrix4. A 2x2 matrix is held in one
+		// register as (m00, m01, m10, m11).
+
+		// lhs * rhs.
+		inline float4 multiplyMatrix2(const float4 lhs, const float4 rhs)
+		{
+			return add(mul(lhs, shuffle<0, 3, 0, 3>(rhs, rhs)),
+				mul(shuffle<1, 0, 3, 2>(lhs, lhs), shuffle<2, 1, 2, 1>(rhs, rhs)));
+		}
+
+		// adjugate(lhs) * rhs.
+		inline float4 multiplyAdjMatrix2(const float4 lhs, const float4 rhs)
+		{
+			return sub(mul(shuffle<3, 3, 0, 0>(lhs, lhs), rhs),
+				mul(shuffle<1, 1, 2, 2>(lhs, lhs), shuffle<2, 3, 0, 1>(rhs, rhs)));
+		}
+
+		// lhs * adjugate(rhs).
+		inline float4 multiplyMatrix2Adj(const float4 lhs, const float4 rhs)
+		{
+			return sub(mul(lhs, shuffle<3, 0, 3, 0>(rhs, rhs)),
+				mul(shuffle<1, 0, 3, 2>(lhs, lhs), shuffle<2, 1, 2, 1>(rhs, rhs)));
+		}
+
+		// Writes the inverse of the 4x4 matrix m to out and returns the
+		// determinant of m, both from the same block-wise computation: m is
+		// split into the 2x2 blocks A B / C D and the inverse is assembled
+		// from their adjugates, which takes about a third of the multiplies
+		// of a cofactor expansion. If the determinant is zero the contents of
+		// out are undefined. The result does not depend on whether m is
+		// stored row- or column-major.
+		inline float inverseMatrix4(const float* m, float* out)
+		{
+			const float4 r0 = load(m + 0);
+			const float4 r1 = load(m + 4);
+			const float4 r2 = load(m + 8);
+			const float4 r3 = load(m + 12);
+
+			const float4 A = shuffle<0, 1, 0, 1>(r0, r1);
+			const float4 B = shuffle<2, 3, 2, 3>(r0, r1);
+			const float4 C = shuffle<0, 1, 0, 1>(r2, r3);
+			const float4 D = shuffle<2, 3, 2, 3>(r2, r3);
+
+			// Determinants of the four blocks as (|A|, |B|, |C|, |D|).
+			const float4 detSub = sub(
+				mul(shuffle<0, 2, 0, 2>(r0, r2), shuffle<1, 3, 1, 3>(r1, r3)),
+				mul(shuffle<1, 3, 1, 3>(r0, r2), shuffle<0, 2, 0, 2>(r1, r3)));
+			const float4 detA = shuffle<0, 0, 0, 0>(detSub, detSub);
+			const float4 detB = shuffle<1, 1, 1, 1>(detSub, detSub);
+			const float4 detC = shuffle<2, 2, 2, 2>(detSub, detSub);
+			const float4 detD = shuffle<3, 3, 3, 3>(detSub, detSub);
+
+			const float4 adjDC = multiplyAdjMatrix2(D, C);
+			const float4 adjAB = multiplyAdjMatrix2(A, B);
+
+			// Adjugates of the blocks of the inverse, X Y / Z W.
+			float4 X = sub(mul(detD, A), multiplyMatrix2(B, adjDC));
+			float4 W = sub(mul(detA, D), multiplyMatrix2(C, adjAB));
+			float4 Y = sub(mul(detB, C), multiplyMatrix2Adj(D, adjAB));
+			float4 Z = sub(mul(detC, B), multiplyMatrix2Adj(A, adjDC));
+
+			// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C).
+			const float4 trace = horizontalSum(mul(adjAB, shuffle<0, 2, 1, 3>(adjDC, adjDC)));
+			const float4 det = sub(add(mul(detA, detD), mul(detB, detC)), trace);
+
+			// Dividing by (|M|, -|M|, -|M|, |M|) also applies the sign pattern
+			// of the final adjugate.
+			const float signs[4] = {1.0f, -1.0f, -1.0f, 1.0f};
+			const float4 invDet = div(load(signs), det);
+			X = mul(X, invDet);
+			Y = mul(Y, invDet);
+			Z = mul(Z, invDet);
+			W = mul(W, invDet);
+
+			// Undo the adjugate shuffle while reassembling the rows.
+			store(out + 0, shuffle<3, 1, 3, 1>(X, Y));
+			store(out + 4, shuffle<2, 0, 2, 0>(X, Y));
+			store(out + 8, shuffle<3, 1, 3, 1>(Z, W));
+			store(out + 12, shuffle<2, 0, 2, 0>(Z, W));
+
+			return first(det);
+		}
+	}
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <M3D/Vector3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace M3D
+{
+	// Uniform grid over a set of points for radius, box and nearest
+	// neighbour queries, without bounds on the world: cells are hashed into
+	// a table twice the size of the point set. Build is a counting sort, so
+	// rebuilding every frame costs about as much as a few passes over the
+	// points.
+	//
+	// Queries return indices into the points given to build(), so they can
+	// be used with whatever array the points came from, for example the
+	// Unity Vector3s of Unity.h, built through the strided overload:
+	//
+	//	grid.build(&targets[0].X, targets.size(), sizeof(targets[0]));
+	//	const std::uint32_t i = grid.nearest(M3D::Vector3(me.X, me.Y, me.Z));
+	//	if (i != SpatialGrid::NONE) aim = GetRotationToLocation(targets[i], 0.5f, me);
+	//
+	// The cell size trades the number of cells a query visits against the
+	// number of points it tests; about the usual query radius works well.
+	// The grid is not thread-safe for writes, but const queries may run
+	// concurrently.
+	class SpatialGrid
+	{
+	public:
+		// Index of no point, returned by nearest() when there is none.
+		static const std::uint32_t NONE;
+
+		// A point returned by the nearest neighbour queries.
+		struct Neighbor
+		{
+			std::uint32_t index;
+			float sqrDistance;
+		};
+
+		explicit SpatialGrid(float cellSize = 1.0f);
+
+		// Changes the cell size. Takes effect at the next build().
+		void setCellSize(float cellSize);
+		float cellSize() const;
+
+		// Replaces the points with count positions.
+		void build(const Vector3* points, std::size_t count);
+
+		// As above, reading three floats every strideBytes bytes from xyz.
+		void build(const float* xyz, std::size_t count, std::size_t strideBytes);
+
+		// Moves the point index. A point that stays in its cell is updated in
+		// place; one that changes cell is set aside in a list every query
+		// scans, until enough have accumulated that the next update()
+		// rebuilds the grid.
+		void update(std::uint32_t index, const Vector3& position);
+
+		std::size_t size() const;
+		bool empty() const;
+		Vector3 position(std::uint32_t index) const;
+
+		// Appends to out the indices of the points within radius of center,
+		// boundary included, and returns how many were appended.
+		std::size_t queryRadius(const Vector3& center, float radius, std::vector<std::uint32_t>& out) const;
+
+		// Appends to out the indices of the points inside the axis-aligned
+		// box [min, max], boundary included, and returns how many were
+		// appended.
+		std::size_t queryBox(const Vector3& min, const Vector3& max, std::vector<std::uint32_t>& out) const;
+
+		// Replaces out with the k points closest to p, no further than
+		// maxDistance, nearest first and ties broken by index.
+		void queryNearest(const Vector3& p, std::size_t k, std::vector<Neighbor>& out,
+			float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+		// Index of the point closest to p, no further than maxDistance, or
+		// NONE.
+		std::uint32_t nearest(const Vector3& p, float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+	private:
+		struct Cell
+		{
+			std::int32_t x, y, z;
+		};
+
+		Cell cellOf(const Vector3& p) const;
+		static std::uint64_t keyOf(const Cell& c);
+		static Cell cellOfKey(std::uint64_t key);
+		std::size_t bucketOf(std::uint64_t key) const;
+
+		// Calls f(slot) for each live slot of the points in cell c.
+		template <typename F>
+		void forEachInCell(const Cell& c, F f) const;
+
+		// Calls consider(index, sqrDistance) for the points around p, moved
+		// ones first and then shell by shell of cells outwards, until every
+		// point left is further than the square root of bound(), or the
+		// shells cover more cells than there are points, when it tests the
+		// points not yet seen one by one.
+		template <typename Consider, typename Bound>
+		void searchNearest(const Vector3& p, Consider consider, Bound bound) const;
+
+		void rebuild();
+
+		float edge;
+		float inverseEdge;
+
+		// Authoritative positions and their cells, by point index.
+		std::vector<Vector3> points;
+		std::vector<std::uint64_t> pointKeys;
+
+		// Points sorted by bucket: the slots of bucket b are
+		// [bucketStart[b], bucketStart[b + 1]). keys holds the cell of each
+		// slot, or DEAD once its point has moved to another cell.
+		std::vector<std::uint32_t> bucketStart;
+		std::vector<float> xs, ys, zs;
+		std::vector<std::uint64_t> keys;
+		std::vector<std::uint32_t> indices;
+
+		// Slot of each point, and the points that moved out of theirs.
+		std::vector<std::uint32_t> slots;
+		std::vector<std::uint32_t> moved;
+
+		// Range of the cells holding points, to bound the nearest queries.
+		Cell lowest, highest;
+		std::size_t mask;
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace M3D
+{
+	// Fixed set of threads that run parallel loops by work stealing. A loop
+	// is cut into chunks, each worker is handed an equal run of them and
+	// takes them from the front, and a worker that runs out takes chunks
+	// from the back of another's run, so uneven chunks even out without a
+	// shared queue.
+	//
+	// The calling thread works too, as worker 0, so a pool of size 1 has no
+	// threads and runs loops inline. parallelFor() may be called from one
+	// thread at a time and not from inside a loop body.
+	class ThreadPool
+	{
+	public:
+		// A pool of threads workers, calling thread included. 0 picks one
+		// per hardware thread.
+		explicit ThreadPool(unsigned int threads = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		// Number of workers, calling thread included.
+		unsigned int size() const;
+
+		// Calls f(begin, end, worker) for consecutive ranges of at most grain
+		// indices covering [0, count), and returns once all calls have. Each
+		// range goes to exactly one call; worker is the index, below size(),
+		// of the worker making it, so f can write to per-worker state
+		// without locking. f must not throw.
+		void parallelFor(std::size_t count, std::size_t grain,
+			const std::function<void(std::size_t, std::size_t, unsigned int)>& f);
+
+	private:
+		// The chunks [front, back) left to a worker.
+		struct Run
+		{
+			std::mutex mutex;
+			std::size_t front;
+			std::size_t back;
+		};
+
+		bool take(unsigned int worker, std::size_t& chunk);
+		void work(unsigned int worker);
+		void loop(unsigned int worker);
+
+		std::vector<std::thread> threads;
+		std::unique_ptr<Run[]> runs;
+		unsigned int workers;
+
+		// The loop being run.
+		const std::function<void(std::size_t, std::size_t, unsigned int)>* body;
+		std::size_t count;
+		std::size_t grain;
+
+		// Workers wait on start for generation to change, and the caller on
+		// done for pending to fall to 0.
+		std::mutex mutex;
+		std::condition_variable start;
+		std::condition_variable done;
+		unsigned long generation;
+		unsigned int pending;
+		bool stopping;
+	};
+}
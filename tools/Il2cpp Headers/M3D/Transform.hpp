@@ -0,0 +1,100 @@
+#pragma once
+
+#include <M3D/Quaternion.hpp>
+#include <M3D/Vector3.hpp>
+
+#include <ostream>
+
+namespace M3D
+{
+	class Matrix4;
+
+	// A pose as Unity's Transform holds it: scale, then rotation, then
+	// translation. Ten floats instead of the sixteen of the equivalent
+	// Matrix4, and composed with a quaternion product and a rotated vector
+	// instead of a 4x4 product.
+	//
+	// Rotation and scale alone cannot represent every product of two poses:
+	// a non-uniform scale under a rotated child shears it. Like Unity's
+	// lossyScale, composition then keeps the per-axis product of the
+	// scales, which is exact when the scales are uniform or the child's
+	// rotation is aligned with the parent's scale axes. inverse() * t is
+	// always the identity, but inverse() only undoes transformPoint() when
+	// the scale is uniform; inverseTransformPoint() is always exact.
+	class Transform
+	{
+	public:
+		Vector3 position;
+		Quaternion rotation;
+		Vector3 scale;
+
+		static const Transform IDENTITY;
+
+		constexpr Transform();
+		constexpr Transform(const Vector3& position_, const Quaternion& rotation_, const Vector3& scale_ = Vector3::ONE);
+
+		// The point, scaled, rotated and translated.
+		constexpr Vector3 transformPoint(const Vector3& point) const;
+
+		// The direction rotated only, as Transform.TransformDirection().
+		constexpr Vector3 transformDirection(const Vector3& direction) const;
+
+		// The vector scaled and rotated, as Transform.TransformVector().
+		constexpr Vector3 transformVector(const Vector3& vector) const;
+
+		// The point this transform maps to point. Needs a non-zero scale.
+		Vector3 inverseTransformPoint(const Vector3& point) const;
+
+		// The transform that composed before this one gives the identity.
+		// Needs a non-zero scale.
+		Transform inverse() const;
+
+		// T * R * S, for column vectors.
+		Matrix4 toMatrix4() const;
+	};
+
+	// The child transform expressed in the space of parent's parent:
+	// (parent * child).transformPoint(p) is
+	// parent.transformPoint(child.transformPoint(p)).
+	constexpr Transform operator*(const Transform& parent, const Transform& child);
+	std::ostream& operator <<(std::ostream& out, const Transform& t);
+
+	constexpr Transform::Transform()
+	: position(0.0f, 0.0f, 0.0f)
+	, rotation(1.0f, 0.0f, 0.0f, 0.0f)
+	, scale(1.0f, 1.0f, 1.0f)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Transform::Transform(const Vector3& position_, const Quaternion& rotation_, const Vector3& scale_)
+	: position(position_)
+	, rotation(rotation_)
+	, scale(scale_)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Transform Transform::IDENTITY = Transform();
+
+	constexpr Vector3 Transform::transformPoint(const Vector3& point) const
+	{
+		return position + rotation * M3D::scale(scale, point);
+	}
+
+	constexpr Vector3 Transform::transformDirection(const Vector3& direction) const
+	{
+		return rotation * direction;
+	}
+
+	constexpr Vector3 Transform::transformVector(const Vector3& vector) const
+	{
+		return rotation * M3D::scale(scale, vector);
+	}
+
+	constexpr Transform operator*(const Transform& parent, const Transform& child)
+	{
+		return Transform(parent.transformPoint(child.position), parent.rotation * child.rotation,
+			scale(parent.scale, child.scale));
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <M3D/Matrix4.hpp>
+#include <M3D/Transform.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace M3D
+{
+	// Parent/child hierarchy of Transforms, as a Unity scene holds them,
+	// with the world matrix of every node computed on demand.
+	//
+	// Nodes live in flat arrays indexed by node, and a parent always comes
+	// before its children, so one forward pass sees every parent's world
+	// matrix before its children need it. Changing a local transform marks
+	// the node and everything below it dirty, stopping at nodes already
+	// dirty, whose subtrees are too. world() then brings a single node up to
+	// date through its dirty ancestors, and update() all the dirty nodes, so
+	// a frame where a few nodes moved costs as much as their subtrees
+	// rather than the whole hierarchy.
+	//
+	// World matrices are products of full matrices, so non-uniform scales
+	// under rotated children shear exactly as in Unity, unlike Transform
+	// composition.
+	class TransformHierarchy
+	{
+	public:
+		// Parent of the roots.
+		static const std::uint32_t NONE;
+
+		TransformHierarchy();
+
+		// Adds a node with local transform local under parent, an existing
+		// node or NONE, and returns its index, which is size() before the
+		// call. The parent of a node cannot be changed later.
+		std::uint32_t add(const Transform& local, std::uint32_t parent = NONE);
+
+		// Reserves room for count nodes.
+		void reserve(std::size_t count);
+
+		// Removes every node.
+		void clear();
+
+		std::size_t size() const;
+		std::uint32_t parent(std::uint32_t node) const;
+		const Transform& local(std::uint32_t node) const;
+
+		// Replaces the local transform of node, relative to its parent.
+		void setLocal(std::uint32_t node, const Transform& local);
+
+		// The matrix from the space of node to world space, brought up to
+		// date first if node or one of its ancestors changed.
+		const Matrix4& world(std::uint32_t node);
+
+		// Brings every dirty world matrix up to date.
+		void update();
+
+		// Number of nodes whose world matrix is out of date.
+		std::size_t dirtyCount() const;
+
+	private:
+		void recompute(std::uint32_t node);
+		void markDirty(std::uint32_t node);
+
+		std::vector<std::uint32_t> parents;
+		std::vector<std::uint32_t> firstChildren;
+		std::vector<std::uint32_t> nextSiblings;
+		std::vector<Transform> locals;
+		std::vector<Matrix4> worlds;
+		std::vector<std::uint8_t> dirty;
+
+		// The nodes marked dirty since the last update(), once each, in the
+		// order they were first marked, and whether each node is listed.
+		// Nodes that world() has since updated stay listed, so that using
+		// world() alone keeps the list within size().
+		std::vector<std::uint32_t> pending;
+		std::vector<std::uint8_t> listed;
+		std::vector<std::uint32_t> stack;
+		std::size_t dirtyNodes;
+	};
+}
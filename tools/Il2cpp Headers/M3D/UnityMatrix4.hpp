@@ -0,0 +1,315 @@
+#pragma once
+
+#include <M3D/Matrix4.hpp>
+#include <M3D/Simd.hpp>
+#include <M3D/Vector3.hpp>
+#include <M3D/Vector4.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <ostream>
+#include <type_traits>
+
+namespace M3D
+{
+	// A 4x4 matrix laid out as Unity's Matrix4x4: column-major, with the
+	// fields m00, m10, m20, m30, m01, ... in that order. Points are column
+	// vectors, as for Matrix4.
+	//
+	// The layout is exactly 16 floats, so a Matrix4x4 in game memory can be
+	// used in place through at(), without the copy and transposed() that a
+	// Matrix4 needs. Products run the Matrix4 kernels with their operands
+	// swapped, since the column-major entries of A are the row-major
+	// entries of its transpose.
+	class UnityMatrix4
+	{
+	public:
+		static const UnityMatrix4 IDENTITY;
+		static const UnityMatrix4 ZERO;
+
+		constexpr UnityMatrix4();
+
+		// The 16 entries in memory order, column after column.
+		constexpr UnityMatrix4(const float arr[16]);
+		constexpr UnityMatrix4(float m00, float m10, float m20, float m30,
+			float m01, float m11, float m21, float m31,
+			float m02, float m12, float m22, float m32,
+			float m03, float m13, float m23, float m33);
+
+		// As Unity's Matrix4x4(Vector4, Vector4, Vector4, Vector4).
+		constexpr UnityMatrix4(const Vector4& column0, const Vector4& column1, const Vector4& column2,
+			const Vector4& column3);
+
+		// The same matrix as A, with its entries transposed into place.
+		explicit constexpr UnityMatrix4(const Matrix4& A);
+
+		// The Matrix4x4 at address, which must be suitably aligned for
+		// floats, used in place.
+		static const UnityMatrix4& at(const void* address);
+		static UnityMatrix4& at(void* address);
+
+		// Entry at row, column.
+		constexpr float operator()(std::size_t row, std::size_t column) const;
+
+		// Entry at index in memory order: row index % 4, column index / 4.
+		constexpr float operator[](std::size_t index) const;
+
+		// The 16 entries in memory order, unchecked, for the SIMD kernels.
+		constexpr const float* data() const;
+
+		constexpr Vector4 column(std::size_t index) const;
+		constexpr Vector4 row(std::size_t index) const;
+
+		// The same matrix as a Matrix4.
+		constexpr Matrix4 toMatrix4() const;
+
+		constexpr UnityMatrix4 transposed() const;
+		constexpr float determinant() const;
+
+		// As the Matrix4 inverses. The bottom row of an affine matrix is
+		// m30, m31, m32, m33 = 0, 0, 0, 1.
+		UnityMatrix4 inverse() const;
+		UnityMatrix4 inverse(float& det) const;
+		UnityMatrix4 inverseAffine() const;
+		UnityMatrix4 inverseRigid() const;
+
+		// As Matrix4x4.MultiplyPoint(), with the perspective divide.
+		Vector3 multiplyPoint(const Vector3& point) const;
+
+		// As Matrix4x4.MultiplyPoint3x4(): the bottom row is ignored.
+		constexpr Vector3 multiplyPoint3x4(const Vector3& point) const;
+
+		// As Matrix4x4.MultiplyVector(): translation is ignored.
+		constexpr Vector3 multiplyVector(const Vector3& vector) const;
+
+		// As Matrix4::frustumPlanes().
+		void frustumPlanes(Vector4 planes[6]) const;
+
+	private:
+		float m[16];
+	};
+
+	static_assert(sizeof(UnityMatrix4) == 16 * sizeof(float), "UnityMatrix4 must be 16 packed floats");
+	static_assert(std::is_standard_layout<UnityMatrix4>::value, "UnityMatrix4 must be standard layout");
+
+	bool operator==(const UnityMatrix4& A, const UnityMatrix4& B);
+	bool operator!=(const UnityMatrix4& A, const UnityMatrix4& B);
+	constexpr UnityMatrix4 operator+(const UnityMatrix4& A, const UnityMatrix4& B);
+	constexpr UnityMatrix4 operator-(const UnityMatrix4& lhs, const UnityMatrix4& rhs);
+	constexpr UnityMatrix4 operator-(const UnityMatrix4& A);
+	constexpr UnityMatrix4 operator*(const UnityMatrix4& A, const float s);
+	constexpr UnityMatrix4 operator*(const float s, const UnityMatrix4& A);
+	Vector4 operator*(const UnityMatrix4& lhs, const Vector4& rhs);
+	Vector4 operator*(const Vector4& lhs, const UnityMatrix4& rhs);
+	UnityMatrix4 operator*(const UnityMatrix4& lhs, const UnityMatrix4& rhs);
+	std::ostream& operator <<(std::ostream& out, const UnityMatrix4& A);
+
+	constexpr UnityMatrix4::UnityMatrix4()
+	: m{1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f}
+	{
+		// Nothing to do.
+	}
+
+	constexpr UnityMatrix4::UnityMatrix4(const float arr[16])
+	: m{arr[0], arr[1], arr[2], arr[3],
+		arr[4], arr[5], arr[6], arr[7],
+		arr[8], arr[9], arr[10], arr[11],
+		arr[12], arr[13], arr[14], arr[15]}
+	{
+		// Nothing to do.
+	}
+
+	constexpr UnityMatrix4::UnityMatrix4(float m00, float m10, float m20, float m30,
+		float m01, float m11, float m21, float m31,
+		float m02, float m12, float m22, float m32,
+		float m03, float m13, float m23, float m33)
+	: m{m00, m10, m20, m30,
+		m01, m11, m21, m31,
+		m02, m12, m22, m32,
+		m03, m13, m23, m33}
+	{
+		// Nothing to do.
+	}
+
+	constexpr UnityMatrix4::UnityMatrix4(const Vector4& column0, const Vector4& column1, const Vector4& column2,
+		const Vector4& column3)
+	: m{column0.x, column0.y, column0.z, column0.w,
+		column1.x, column1.y, column1.z, column1.w,
+		column2.x, column2.y, column2.z, column2.w,
+		column3.x, column3.y, column3.z, column3.w}
+	{
+		// Nothing to do.
+	}
+
+	constexpr UnityMatrix4::UnityMatrix4(const Matrix4& A)
+	: m{A[0], A[4], A[8], A[12],
+		A[1], A[5], A[9], A[13],
+		A[2], A[6], A[10], A[14],
+		A[3], A[7], A[11], A[15]}
+	{
+		// Nothing to do.
+	}
+
+	constexpr UnityMatrix4 UnityMatrix4::IDENTITY = UnityMatrix4();
+	constexpr UnityMatrix4 UnityMatrix4::ZERO = UnityMatrix4(
+		0.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 0.0f
+	);
+
+	inline const UnityMatrix4& UnityMatrix4::at(const void* address)
+	{
+		return *static_cast<const UnityMatrix4*>(address);
+	}
+
+	inline UnityMatrix4& UnityMatrix4::at(void* address)
+	{
+		return *static_cast<UnityMatrix4*>(address);
+	}
+
+	constexpr float UnityMatrix4::operator()(std::size_t row, std::size_t column) const
+	{
+		assert(row < 4 && column < 4);
+		return m[4 * column + row];
+	}
+
+	constexpr float UnityMatrix4::operator[](std::size_t index) const
+	{
+		assert(index < 16);
+		return m[index];
+	}
+
+	constexpr const float* UnityMatrix4::data() const
+	{
+		return m;
+	}
+
+	constexpr Vector4 UnityMatrix4::column(std::size_t index) const
+	{
+		assert(index < 4);
+		return Vector4(m[4 * index + 0], m[4 * index + 1], m[4 * index + 2], m[4 * index + 3]);
+	}
+
+	constexpr Vector4 UnityMatrix4::row(std::size_t index) const
+	{
+		assert(index < 4);
+		return Vector4(m[index], m[index + 4], m[index + 8], m[index + 12]);
+	}
+
+	constexpr Matrix4 UnityMatrix4::toMatrix4() const
+	{
+		return Matrix4(
+			m[0], m[4], m[8], m[12],
+			m[1], m[5], m[9], m[13],
+			m[2], m[6], m[10], m[14],
+			m[3], m[7], m[11], m[15]
+		);
+	}
+
+	constexpr UnityMatrix4 UnityMatrix4::transposed() const
+	{
+		return UnityMatrix4(
+			m[0], m[4], m[8], m[12],
+			m[1], m[5], m[9], m[13],
+			m[2], m[6], m[10], m[14],
+			m[3], m[7], m[11], m[15]
+		);
+	}
+
+	constexpr float UnityMatrix4::determinant() const
+	{
+		// A matrix and its transpose have the same determinant.
+		return Matrix4(m).determinant();
+	}
+
+	constexpr Vector3 UnityMatrix4::multiplyPoint3x4(const Vector3& point) const
+	{
+		return Vector3(
+			m[0] * point.x + m[4] * point.y + m[8] * point.z + m[12],
+			m[1] * point.x + m[5] * point.y + m[9] * point.z + m[13],
+			m[2] * point.x + m[6] * point.y + m[10] * point.z + m[14]
+		);
+	}
+
+	constexpr Vector3 UnityMatrix4::multiplyVector(const Vector3& vector) const
+	{
+		return Vector3(
+			m[0] * vector.x + m[4] * vector.y + m[8] * vector.z,
+			m[1] * vector.x + m[5] * vector.y + m[9] * vector.z,
+			m[2] * vector.x + m[6] * vector.y + m[10] * vector.z
+		);
+	}
+
+	constexpr UnityMatrix4 operator+(const UnityMatrix4& A, const UnityMatrix4& B)
+	{
+		return UnityMatrix4(
+			A[0] + B[0], A[1] + B[1], A[2] + B[2], A[3] + B[3],
+			A[4] + B[4], A[5] + B[5], A[6] + B[6], A[7] + B[7],
+			A[8] + B[8], A[9] + B[9], A[10] + B[10], A[11] + B[11],
+			A[12] + B[12], A[13] + B[13], A[14] + B[14], A[15] + B[15]
+		);
+	}
+
+	constexpr UnityMatrix4 operator-(const UnityMatrix4& lhs, const UnityMatrix4& rhs)
+	{
+		return UnityMatrix4(
+			lhs[0] - rhs[0], lhs[1] - rhs[1], lhs[2] - rhs[2], lhs[3] - rhs[3],
+			lhs[4] - rhs[4], lhs[5] - rhs[5], lhs[6] - rhs[6], lhs[7] - rhs[7],
+			lhs[8] - rhs[8], lhs[9] - rhs[9], lhs[10] - rhs[10], lhs[11] - rhs[11],
+			lhs[12] - rhs[12], lhs[13] - rhs[13], lhs[14] - rhs[14], lhs[15] - rhs[15]
+		);
+	}
+
+	constexpr UnityMatrix4 operator-(const UnityMatrix4& A)
+	{
+		return UnityMatrix4(
+			-A[0], -A[1], -A[2], -A[3],
+			-A[4], -A[5], -A[6], -A[7],
+			-A[8], -A[9], -A[10], -A[11],
+			-A[12], -A[13], -A[14], -A[15]
+		);
+	}
+
+	constexpr UnityMatrix4 operator*(const UnityMatrix4& A, const float s)
+	{
+		return UnityMatrix4(
+			A[0] * s, A[1] * s, A[2] * s, A[3] * s,
+			A[4] * s, A[5] * s, A[6] * s, A[7] * s,
+			A[8] * s, A[9] * s, A[10] * s, A[11] * s,
+			A[12] * s, A[13] * s, A[14] * s, A[15] * s
+		);
+	}
+
+	constexpr UnityMatrix4 operator*(const float s, const UnityMatrix4& A)
+	{
+		return A * s;
+	}
+
+	inline Vector4 operator*(const UnityMatrix4& lhs, const Vector4& rhs)
+	{
+		// A * v is v^T * A^T, and the entries of A are those of A^T in
+		// row-major order.
+		Vector4 result;
+		simd::multiplyVector4Matrix4(&rhs.x, lhs.data(), &result.x);
+		return result;
+	}
+
+	inline Vector4 operator*(const Vector4& lhs, const UnityMatrix4& rhs)
+	{
+		Vector4 result;
+		simd::multiplyMatrix4Vector4(rhs.data(), &lhs.x, &result.x);
+		return result;
+	}
+
+	inline UnityMatrix4 operator*(const UnityMatrix4& lhs, const UnityMatrix4& rhs)
+	{
+		// (A * B)^T = B^T * A^T.
+		float result[16];
+		simd::multiplyMatrix4(rhs.data(), lhs.data(), result);
+		return UnityMatrix4(result);
+	}
+}
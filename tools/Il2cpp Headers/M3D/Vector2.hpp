@@ -0,0 +1,151 @@
+#pragma once
+
+#include <M3D/Precision.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <ostream>
+
+namespace M3D
+{
+	class Vector2
+	{
+	public:
+		float x;
+		float y;
+
+		static const Vector2 UP;
+		static const Vector2 DOWN;
+		static const Vector2 RIGHT;
+		static const Vector2 LEFT;
+		static const Vector2 ONE;
+		static const Vector2 ZERO;
+
+		constexpr Vector2();
+		constexpr Vector2(float x_, float y_);
+
+		constexpr float sqrMagnitude() const;
+		template <Precision P = Precision::Exact> float magnitude() const;
+		template <Precision P = Precision::Exact> Vector2 normalized() const;
+		template <Precision P = Precision::Exact> void normalize();
+	};
+
+	float operator==(const Vector2& v1, const Vector2& v2);
+	float operator!=(const Vector2& v1, const Vector2& v2);
+	constexpr Vector2 operator+(const Vector2& v1, const Vector2& v2);
+	constexpr Vector2 operator-(const Vector2& v1, const Vector2& v2);
+	constexpr Vector2 operator-(const Vector2& v);
+	constexpr Vector2 operator*(const Vector2& v, const float s);
+	constexpr Vector2 operator*(const float s, const Vector2& v);
+	constexpr Vector2 operator/(const Vector2& v, const float s);
+	std::ostream& operator <<(std::ostream& out, const Vector2& v);
+
+	constexpr Vector2 scale(const Vector2& v1, const Vector2& v2);
+	constexpr float dot(const Vector2& lhs, const Vector2& rhs);
+	template <Precision P = Precision::Exact>
+	float angle(const Vector2& from, const Vector2& to);
+	constexpr float sqrDistance(const Vector2& p1, const Vector2& p2);
+	float distance(const Vector2& p1, const Vector2& p2);
+
+	constexpr Vector2::Vector2()
+	: x(0.0f)
+	, y(0.0f)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Vector2::Vector2(float x_, float y_)
+	: x(x_)
+	, y(y_)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Vector2 Vector2::UP		= Vector2(0.0f, 1.0f);
+	constexpr Vector2 Vector2::DOWN		= Vector2(0.0f, -1.0f);
+	constexpr Vector2 Vector2::RIGHT	= Vector2(1.0f, 0.0f);
+	constexpr Vector2 Vector2::LEFT		= Vector2(-1.0f, 0.0f);
+	constexpr Vector2 Vector2::ONE		= Vector2(1.0f, 1.0f);
+	constexpr Vector2 Vector2::ZERO		= Vector2(0.0f, 0.0f);
+
+	constexpr Vector2 operator+(const Vector2& v1, const Vector2& v2)
+	{
+		return Vector2(v1.x + v2.x, v1.y + v2.y);
+	}
+
+	constexpr Vector2 operator-(const Vector2& v1, const Vector2& v2)
+	{
+		return Vector2(v1.x - v2.x, v1.y - v2.y);
+	}
+
+	constexpr Vector2 operator-(const Vector2& v)
+	{
+		return Vector2(-v.x, -v.y);
+	}
+
+	constexpr Vector2 operator*(const Vector2& v, const float s)
+	{
+		return Vector2(v.x * s, v.y * s);
+	}
+
+	constexpr Vector2 operator*(const float s, const Vector2& v)
+	{
+		return v * s;
+	}
+
+	constexpr Vector2 operator/(const Vector2& v, const float s)
+	{
+		assert(s != 0.0f);
+		return v * (1.0f / s);
+	}
+
+	constexpr float Vector2::sqrMagnitude() const
+	{
+		// Take the dot product of this vector with itself.
+		return dot(*this, *this);
+	}
+
+	template <Precision P>
+	inline float Vector2::magnitude() const
+	{
+		return Math<P>::sqrt(sqrMagnitude());
+	}
+
+	template <Precision P>
+	inline Vector2 Vector2::normalized() const
+	{
+		assert(sqrMagnitude() != 0.0f);
+		const float invLength = Math<P>::rsqrt(sqrMagnitude());
+		return *this * invLength;
+	}
+
+	template <Precision P>
+	inline void Vector2::normalize()
+	{
+		assert(sqrMagnitude() != 0.0f);
+		const float invLength = Math<P>::rsqrt(sqrMagnitude());
+
+		x *= invLength;
+		y *= invLength;
+	}
+
+	constexpr Vector2 scale(const Vector2& v1, const Vector2& v2)
+	{
+		return Vector2(v1.x * v2.x, v1.y * v2.y);
+	}
+
+	constexpr float dot(const Vector2& lhs, const Vector2& rhs)
+	{
+		return lhs.x * rhs.x + lhs.y * rhs.y;
+	}
+
+	constexpr float sqrDistance(const Vector2& p1, const Vector2& p2)
+	{
+		return (p1 - p2).sqrMagnitude();
+	}
+
+	inline float distance(const Vector2& p1, const Vector2& p2)
+	{
+		return (p1 - p2).magnitude();
+	}
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <M3D/Precision.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <ostream>
+
+namespace M3D
+{
+	class Vector4;
+
+	class Vector3
+	{
+	public:
+		float x;
+		float y;
+		float z;
+
+		static const Vector3 FORWARD;
+		static const Vector3 BACK;
+		static const Vector3 UP;
+		static const Vector3 DOWN;
+		static const Vector3 RIGHT;
+		static const Vector3 LEFT;
+		static const Vector3 ONE;
+		static const Vector3 ZERO;
+
+		constexpr Vector3();
+		constexpr Vector3(float x_, float y_, float z_);
+
+		// Drops the w component. Defined in Vector4.hpp.
+		explicit constexpr Vector3(const Vector4& v);
+
+		constexpr float sqrMagnitude() const;
+		template <Precision P = Precision::Exact> float magnitude() const;
+		template <Precision P = Precision::Exact> Vector3 normalized() const;
+		template <Precision P = Precision::Exact> void normalize();
+	};
+
+	float operator==(const Vector3& v1, const Vector3& v2);
+	float operator!=(const Vector3& v1, const Vector3& v2);
+	constexpr Vector3 operator+(const Vector3& v1, const Vector3& v2);
+	constexpr Vector3& operator+=(Vector3& v1, const Vector3& v2);
+	constexpr Vector3 operator-(const Vector3& v1, const Vector3& v2);
+	constexpr Vector3& operator-=(Vector3& v1, const Vector3& v2);
+	constexpr Vector3 operator-(const Vector3& v);
+	constexpr Vector3 operator*(const Vector3& v, const float s);
+	constexpr Vector3& operator*=(Vector3& v, const float s);
+	constexpr Vector3 operator*(const float s, const Vector3& v);
+	constexpr Vector3 operator/(const Vector3& v, const float s);
+	constexpr Vector3& operator/=(Vector3& v, const float s);
+	std::ostream& operator <<(std::ostream& out, const Vector3& v);
+
+	constexpr Vector3 scale(const Vector3& v1, const Vector3& v2);
+	constexpr float dot(const Vector3& lhs, const Vector3& rhs);
+	constexpr Vector3 cross(const Vector3& lhs, const Vector3& rhs);
+	constexpr Vector3 lerp(const Vector3& from, const Vector3& to, float factor);
+	template <Precision P = Precision::Exact>
+	float angle(const Vector3& from, const Vector3& to);
+	constexpr float sqrDistance(const Vector3& p1, const Vector3& p2);
+	float distance(const Vector3& p1, const Vector3& p2);
+
+	constexpr Vector3::Vector3()
+	: x(0.0f)
+	, y(0.0f)
+	, z(0.0f)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Vector3::Vector3(float x_, float y_, float z_)
+	: x(x_)
+	, y(y_)
+	, z(z_)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Vector3 Vector3::FORWARD	= Vector3(0.0f, 0.0f, 1.0f);
+	constexpr Vector3 Vector3::BACK		= Vector3(0.0f, 0.0f, -1.0f);
+	constexpr Vector3 Vector3::UP		= Vector3(0.0f, 1.0f, 0.0f);
+	constexpr Vector3 Vector3::DOWN		= Vector3(0.0f, -1.0f, 0.0f);
+	constexpr Vector3 Vector3::RIGHT	= Vector3(1.0f, 0.0f, 0.0f);
+	constexpr Vector3 Vector3::LEFT		= Vector3(-1.0f, 0.0f, 0.0f);
+	constexpr Vector3 Vector3::ONE		= Vector3(1.0f, 1.0f, 1.0f);
+	constexpr Vector3 Vector3::ZERO		= Vector3(0.0f, 0.0f, 0.0f);
+
+	constexpr Vector3 operator+(const Vector3& v1, const Vector3& v2)
+	{
+		return Vector3(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z);
+	}
+
+	constexpr Vector3& operator+=(Vector3& v1, const Vector3& v2)
+	{
+		v1.x += v2.x;
+		v1.y += v2.y;
+		v1.z += v2.z;
+
+		return v1;
+	}
+
+	constexpr Vector3 operator-(const Vector3& v1, const Vector3& v2)
+	{
+		return Vector3(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z);
+	}
+
+	constexpr Vector3& operator-=(Vector3& v1, const Vector3& v2)
+	{
+		v1.x -= v2.x;
+		v1.y -= v2.y;
+		v1.z -= v2.z;
+
+		return v1;
+	}
+
+	constexpr Vector3 operator-(const Vector3& v)
+	{
+		return Vector3(-v.x, -v.y, -v.z);
+	}
+
+	constexpr Vector3 operator*(const Vector3& v, const float s)
+	{
+		return Vector3(v.x * s, v.y * s, v.z * s);
+	}
+
+	constexpr Vector3& operator*=(Vector3& v, const float s)
+	{
+		v.x *= s;
+		v.y *= s;
+		v.z *= s;
+
+		return v;
+	}
+
+	constexpr Vector3 operator*(const float s, const Vector3& v)
+	{
+		return v * s;
+	}
+
+	constexpr Vector3 operator/(const Vector3& v, const float s)
+	{
+		assert(s != 0.0f);
+		return v * (1.0f / s);
+	}
+
+	constexpr Vector3& operator/=(Vector3& v, const float s)
+	{
+		assert(s != 0.0f);
+		v.x /= s;
+		v.y /= s;
+		v.z /= s;
+
+		return v;
+	}
+
+	constexpr float Vector3::sqrMagnitude() const
+	{
+		// Take the dot product of this vector with itself.
+		return dot(*this, *this);
+	}
+
+	template <Precision P>
+	inline float Vector3::magnitude() const
+	{
+		return Math<P>::sqrt(sqrMagnitude());
+	}
+
+	template <Precision P>
+	inline Vector3 Vector3::normalized() const
+	{
+		assert(sqrMagnitude() != 0.0f);
+		const float invLength = Math<P>::rsqrt(sqrMagnitude());
+		return *this * invLength;
+	}
+
+	template <Precision P>
+	inline void Vector3::normalize()
+	{
+		assert(sqrMagnitude() != 0.0f);
+		const float invLength = Math<P>::rsqrt(sqrMagnitude());
+
+		x *= invLength;
+		y *= invLength;
+		z *= invLength;
+	}
+
+	constexpr Vector3 scale(const Vector3& v1, const Vector3& v2)
+	{
+		return Vector3(v1.x * v2.x, v1.y * v2.y, v1.z * v2.z);
+	}
+
+	constexpr float dot(const Vector3& lhs, const Vector3& rhs)
+	{
+		return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
+	}
+
+	constexpr Vector3 cross(const Vector3& lhs, const Vector3& rhs)
+	{
+		return Vector3(
+			lhs.y * rhs.z - lhs.z * rhs.y,
+			lhs.z * rhs.x - lhs.x * rhs.z,
+			lhs.x * rhs.y - lhs.y * rhs.x
+		);
+	}
+
+	constexpr Vector3 lerp(const Vector3& from, const Vector3& to, float factor)
+	{
+		return from * (1.0f - factor) + to * factor;
+	}
+
+	constexpr float sqrDistance(const Vector3& p1, const Vector3& p2)
+	{
+		return (p1 - p2).sqrMagnitude();
+	}
+
+	inline float distance(const Vector3& p1, const Vector3& p2)
+	{
+		return (p1 - p2).magnitude();
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <M3D/Quaternion.hpp>
+#include <M3D/Vector3.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace M3D
+{
+	// A list of Vector3s stored as structure-of-arrays: one contiguous array
+	// per component. This is the layout the bulk kernels below stream over,
+	// four elements per register.
+	class Vector3SoA
+	{
+	public:
+		Vector3SoA();
+		explicit Vector3SoA(std::size_t size);
+		Vector3SoA(const Vector3* v, std::size_t count);
+
+		// Returns a copy of the element at index.
+		Vector3 operator[](std::size_t index) const;
+
+		void set(std::size_t index, const Vector3& v);
+		void append(const Vector3& v);
+
+		// Replaces the contents with count elements read from v.
+		void assign(const Vector3* v, std::size_t count);
+
+		// Writes all elements to out, which must hold size() Vector3s.
+		void copyTo(Vector3* out) const;
+
+		std::size_t size() const;
+		bool empty() const;
+		void resize(std::size_t size);
+		void reserve(std::size_t capacity);
+		void clear();
+
+		float* x();
+		float* y();
+		float* z();
+		const float* x() const;
+		const float* y() const;
+		const float* z() const;
+
+	private:
+		std::vector<float> xs;
+		std::vector<float> ys;
+		std::vector<float> zs;
+	};
+
+	// Element-wise kernels. Outputs are written to caller-provided arrays
+	// holding at least as many elements as the inputs; SoA outputs are
+	// resized to match. Paired SoA inputs must have the same size.
+
+	// out[i] = dot(a[i], b[i]).
+	void dot(const Vector3SoA& a, const Vector3SoA& b, float* out);
+
+	// out[i] = dot(a[i], b).
+	void dot(const Vector3SoA& a, const Vector3& b, float* out);
+
+	// out[i] = cross(a[i], b[i]). out may be a or b.
+	void cross(const Vector3SoA& a, const Vector3SoA& b, Vector3SoA& out);
+
+	// out[i] = cross(a[i], b). out may be a.
+	void cross(const Vector3SoA& a, const Vector3& b, Vector3SoA& out);
+
+	// out[i] = sqrDistance(p, points[i]).
+	void sqrDistance(const Vector3& p, const Vector3SoA& points, float* out);
+
+	// out[i] = sqrDistance(a[i], b[i]).
+	void sqrDistance(const Vector3SoA& a, const Vector3SoA& b, float* out);
+
+	// out[i] = distance(p, points[i]).
+	void distance(const Vector3& p, const Vector3SoA& points, float* out);
+
+	// out[i] = distance(a[i], b[i]).
+	void distance(const Vector3SoA& a, const Vector3SoA& b, float* out);
+
+	// out[i] = q * in[i]. out may be in.
+	void rotate(const Quaternion& q, const Vector3SoA& in, Vector3SoA& out);
+
+	// out[i] = in[i].normalized(). Unlike Vector3::normalized(), zero-length
+	// inputs are not an error: they are written as Vector3::ZERO and flagged
+	// false in valid (if given). Returns the number of valid elements. out
+	// may be in.
+	std::size_t normalize(const Vector3SoA& in, Vector3SoA& out, bool* valid = nullptr);
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <M3D/Vector3.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <ostream>
+
+namespace M3D
+{
+	class Vector4
+	{
+	public:
+		float x;
+		float y;
+		float z;
+		float w;
+
+		static const Vector4 FORWARD;
+		static const Vector4 BACK;
+		static const Vector4 UP;
+		static const Vector4 DOWN;
+		static const Vector4 RIGHT;
+		static const Vector4 LEFT;
+		static const Vector4 ONE;
+		static const Vector4 ZERO;
+
+		constexpr Vector4();
+		constexpr Vector4(float x_, float y_, float z_, float w_);
+
+		// Takes w as 0, i.e. a direction.
+		explicit constexpr Vector4(const Vector3& v);
+		constexpr Vector4(const Vector3& v, float w_);
+
+		constexpr float sqrMagnitude() const;
+		template <Precision P = Precision::Exact> float magnitude() const;
+		template <Precision P = Precision::Exact> Vector4 normalized() const;
+		template <Precision P = Precision::Exact> void normalize();
+	};
+
+	float operator==(const Vector4& v1, const Vector4& v2);
+	float operator!=(const Vector4& v1, const Vector4& v2);
+	constexpr Vector4 operator+(const Vector4& v1, const Vector4& v2);
+	constexpr Vector4 operator-(const Vector4& v1, const Vector4& v2);
+	constexpr Vector4 operator-(const Vector4& v);
+	constexpr Vector4 operator*(const Vector4& v, const float s);
+	constexpr Vector4 operator*(const float s, const Vector4& v);
+	constexpr Vector4 operator/(const Vector4& v, const float s);
+	std::ostream& operator <<(std::ostream& out, const Vector4& v);
+
+	constexpr Vector4 scale(const Vector4& v1, const Vector4& v2);
+	constexpr float dot(const Vector4& lhs, const Vector4& rhs);
+	constexpr float sqrDistance(const Vector4& p1, const Vector4& p2);
+	float distance(const Vector4& p1, const Vector4& p2);
+
+	constexpr Vector3::Vector3(const Vector4& v)
+	: x(v.x)
+	, y(v.y)
+	, z(v.z)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Vector4::Vector4()
+	: x(0.0f)
+	, y(0.0f)
+	, z(0.0f)
+	, w(0.0f)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Vector4::Vector4(float x_, float y_, float z_, float w_)
+	: x(x_)
+	, y(y_)
+	, z(z_)
+	, w(w_)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Vector4::Vector4(const Vector3& v)
+	: x(v.x)
+	, y(v.y)
+	, z(v.z)
+	, w(0.0f)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Vector4::Vector4(const Vector3& v, float w_)
+	: x(v.x)
+	, y(v.y)
+	, z(v.z)
+	, w(w_)
+	{
+		// Nothing to do.
+	}
+
+	constexpr Vector4 Vector4::FORWARD	= Vector4(0.0f, 0.0f, 1.0f, 0.0f);
+	constexpr Vector4 Vector4::BACK		= Vector4(0.0f, 0.0f, -1.0f, 0.0f);
+	constexpr Vector4 Vector4::UP		= Vector4(0.0f, 1.0f, 0.0f, 0.0f);
+	constexpr Vector4 Vector4::DOWN		= Vector4(0.0f, -1.0f, 0.0f, 0.0f);
+	constexpr Vector4 Vector4::RIGHT	= Vector4(1.0f, 0.0f, 0.0f, 0.0f);
+	constexpr Vector4 Vector4::LEFT		= Vector4(-1.0f, 0.0f, 0.0f, 0.0f);
+	constexpr Vector4 Vector4::ONE		= Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+	constexpr Vector4 Vector4::ZERO		= Vector4(0.0f, 0.0f, 0.0f, 0.0f);
+
+	constexpr Vector4 operator+(const Vector4& v1, const Vector4& v2)
+	{
+		return Vector4(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z, v1.w + v2.w);
+	}
+
+	constexpr Vector4 operator-(const Vector4& v1, const Vector4& v2)
+	{
+		return Vector4(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z, v1.w - v2.w);
+	}
+
+	constexpr Vector4 operator-(const Vector4& v)
+	{
+		return Vector4(-v.x, -v.y, -v.z, -v.w);
+	}
+
+	constexpr Vector4 operator*(const Vector4& v, const float s)
+	{
+		return Vector4(v.x * s, v.y * s, v.z * s, v.w * s);
+	}
+
+	constexpr Vector4 operator*(const float s, const Vector4& v)
+	{
+		return v * s;
+	}
+
+	constexpr Vector4 operator/(const Vector4& v, const float s)
+	{
+		assert(s != 0.0f);
+		return v * (1.0f / s);
+	}
+
+	constexpr float Vector4::sqrMagnitude() const
+	{
+		// Take the dot product of this vector with itself.
+		return dot(*this, *this);
+	}
+
+	template <Precision P>
+	inline float Vector4::magnitude() const
+	{
+		return Math<P>::sqrt(sqrMagnitude());
+	}
+
+	template <Precision P>
+	inline Vector4 Vector4::normalized() const
+	{
+		assert(sqrMagnitude() != 0.0f);
+		const float invLength = Math<P>::rsqrt(sqrMagnitude());
+		return (*this) * invLength;
+	}
+
+	template <Precision P>
+	inline void Vector4::normalize()
+	{
+		assert(sqrMagnitude() != 0.0f);
+		const float invLength = Math<P>::rsqrt(sqrMagnitude());
+
+		x *= invLength;
+		y *= invLength;
+		z *= invLength;
+		w *= invLength;
+	}
+
+	constexpr Vector4 scale(const Vector4& v1, const Vector4& v2)
+	{
+		return Vector4(v1.x * v2.x, v1.y * v2.y, v1.z * v2.z, v1.w * v2.w);
+	}
+
+	constexpr float dot(const Vector4& lhs, const Vector4& rhs)
+	{
+		return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z + lhs.w * rhs.w;
+	}
+
+	constexpr float sqrDistance(const Vector4& p1, const Vector4& p2)
+	{
+		return (p1 - p2).sqrMagnitude();
+	}
+
+	inline float distance(const Vector4& p1, const Vector4& p2)
+	{
+		return (p1 - p2).magnitude();
+	}
+}
@@ -2,38 +2,10 @@
 
 #include <cmath>
 #include <cassert>
-#include <cstring>
+#include <string>
 
 namespace M3D
 {
-	const Matrix3 Matrix3::IDENTITY = Matrix3();
-	const Matrix3 Matrix3::ZERO = Matrix3({0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f});
-
-	Matrix3::Matrix3()
-	: m{1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f}
-	{
-		// Nothing to do.
-	}
-
-	Matrix3::Matrix3(const float arr[9])
-	{
-		std::memcpy(m, arr, 9 * sizeof(float));
-	}
-
-	Matrix3::Matrix3(float entry00, float entry01, float entry02,
-		float entry10, float entry11, float entry12,
-		float entry20, float entry21, float entry22)
-	: m{entry00, entry01, entry02, entry10, entry11, entry12, entry20, entry21, entry22}
-	{
-		// Nothing to do.
-	}
-
-	float Matrix3::operator[](std::size_t index) const
-	{
-		assert(index < 9);
-		return m[index];
-	}
-
 	bool operator==(const Matrix3& A, const Matrix3& B)
 	{
 		const float epsilon = 1e-6;
@@ -50,82 +22,6 @@ namespace M3D
 		return !(A == B);
 	}
 
-	Matrix3 operator+(const Matrix3& A, const Matrix3& B)
-	{
-		return Matrix3(
-			A[0] + B[0], A[1] + B[1], A[2] + B[2],
-			A[3] + B[3], A[4] + B[4], A[5] + B[5],
-			A[6] + B[6], A[7] + B[7], A[8] + B[8]
-		);
-	}
-
-	Matrix3 operator-(const Matrix3& lhs, const Matrix3& rhs)
-	{
-		return Matrix3(
-			lhs[0] - rhs[0], lhs[1] - rhs[1], lhs[2] - rhs[2],
-			lhs[3] - rhs[3], lhs[4] - rhs[4], lhs[5] - rhs[5],
-			lhs[6] - rhs[6], lhs[7] - rhs[7], lhs[8] - rhs[8]
-		);
-	}
-
-	Matrix3 operator-(const Matrix3& A)
-	{
-		return Matrix3(
-			-A[0], -A[1], -A[2],
-			-A[3], -A[4], -A[5],
-			-A[6], -A[7], -A[8]
-		);
-	}
-
-	Matrix3 operator*(const Matrix3& A, const float s)
-	{
-		return Matrix3(
-			A[0] * s, A[1] * s, A[2] * s,
-			A[3] * s, A[4] * s, A[5] * s,
-			A[6] * s, A[7] * s, A[8] * s
-		);
-	}
-
-	Matrix3 operator*(const float s, const Matrix3& A)
-	{
-		return A * s;
-	}
-
-	Vector3 operator*(const Matrix3& lhs, const Vector3& rhs)
-	{
-		return Vector3(
-			lhs[0] * rhs.x + lhs[1] * rhs.y + lhs[2] * rhs.z,
-			lhs[3] * rhs.x + lhs[4] * rhs.y + lhs[5] * rhs.z,
-			lhs[6] * rhs.x + lhs[7] * rhs.y + lhs[8] * rhs.z
-		);
-	}
-
-	Vector3 operator*(const Vector3& lhs, const Matrix3& rhs)
-	{
-		return Vector3(
-			lhs.x * rhs[0] + lhs.y * rhs[3] + lhs.z * rhs[6],
-			lhs.x * rhs[1] + lhs.y * rhs[4] + lhs.z * rhs[7],
-			lhs.x * rhs[2] + lhs.y * rhs[5] + lhs.z * rhs[8]
-		);
-	}
-
-	Matrix3 operator*(const Matrix3& lhs, const Matrix3& rhs)
-	{
-		return Matrix3(
-			lhs[0] * rhs[0] + lhs[1] * rhs[3] + lhs[2] * rhs[6],
-			lhs[0] * rhs[1] + lhs[1] * rhs[4] + lhs[2] * rhs[7],
-			lhs[0] * rhs[2] + lhs[1] * rhs[5] + lhs[2] * rhs[8],
-
-			lhs[3] * rhs[0] + lhs[4] * rhs[3] + lhs[5] * rhs[6],
-			lhs[3] * rhs[1] + lhs[4] * rhs[4] + lhs[5] * rhs[7],
-			lhs[3] * rhs[2] + lhs[4] * rhs[5] + lhs[5] * rhs[8],
-
-			lhs[6] * rhs[0] + lhs[7] * rhs[3] + lhs[8] * rhs[6],
-			lhs[6] * rhs[1] + lhs[7] * rhs[4] + lhs[8] * rhs[7],
-			lhs[6] * rhs[2] + lhs[7] * rhs[5] + lhs[8] * rhs[8]
-		);
-	}
-
 	std::ostream& operator <<(std::ostream& out, const Matrix3& A)
 	{
 		std::string stringMatrix[9];
@@ -178,28 +74,6 @@ namespace M3D
 		return out;
 	}
 
-	Matrix3 Matrix3::transposed() const
-	{
-		return Matrix3(
-			m[0], m[3], m[6],
-			m[1], m[4], m[7],
-			m[2], m[5], m[8]
-		);
-	}
-
-	void Matrix3::transpose()
-	{
-		std::swap(m[1], m[3]);
-		std::swap(m[2], m[6]);
-		std::swap(m[5], m[7]);
-	}
-
-	float Matrix3::determinant() const
-	{
-		return m[0] * m[4] * m[8] + m[1] * m[5] * m[6] + m[2] * m[3] * m[7]
-			- m[6] * m[4] * m[2] - m[7] * m[5] * m[0] - m[8] * m[3] * m[1];
-	}
-
 	Matrix3 Matrix3::inverse() const
 	{
 		// Ensure that the matrix is not singular.
@@ -1,80 +1,15 @@
 #include <M3D/Matrix4.hpp>
 #include <M3D/Quaternion.hpp>
+#include <M3D/Simd.hpp>
 #include <M3D/Vector3.hpp>
 #include <M3D/Vector4.hpp>
 
 #include <cmath>
 #include <cassert>
-#include <cstring>
+#include <string>
 
 namespace M3D
 {
-	const Matrix4 Matrix4::IDENTITY = Matrix4();
-	const Matrix4 Matrix4::ZERO = Matrix4({
-		0.0f, 0.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, 0.0f, 0.0f
-	});
-
-	Matrix4::Matrix4()
-	: m{1.0f, 0.0f, 0.0f, 0.0f,
-		0.0f, 1.0f, 0.0f, 0.0f,
-		0.0f, 0.0f, 1.0f, 0.0f,
-		0.0f, 0.0f, 0.0f, 1.0f}
-	{
-		// Nothing to do.
-	}
-
-	Matrix4::Matrix4(const float arr[16])
-	{
-		std::memcpy(m, arr, 16 * sizeof(float));
-	}
-
-	Matrix4::Matrix4(float entry00, float entry01, float entry02, float entry03,
-		float entry10, float entry11, float entry12, float entry13,
-		float entry20, float entry21, float entry22, float entry23,
-		float entry30, float entry31, float entry32, float entry33)
-	: m{entry00, entry01, entry02, entry03,
-		entry10, entry11, entry12, entry13,
-		entry20, entry21, entry22, entry23,
-		entry30, entry31, entry32, entry33}
-	{
-		// Nothing to do.
-	}
-
-	Matrix4::Matrix4(const Matrix3& A)
-	: m{A[0], A[1], A[2], 0.0f,
-		A[3], A[4], A[5], 0.0f,
-		A[6], A[7], A[8], 0.0f,
-		0.0f, 0.0f, 0.0f, 1.0f}
-	{
-		// Nothing to do.
-	}
-
-	Matrix4::Matrix4(const Quaternion& q)
-	: m{1.0f - 2.0f * q.y * q.y - 2.0f * q.z * q.z,
-		2.0f * q.x * q.y - 2.0f * q.w * q.z,
-		2.0f * q.x * q.z + 2.0f * q.w * q.y,
-		0.0f,
-		2.0f * q.x * q.y + 2.0f * q.w * q.z,
-		1.0f - 2.0f * q.x * q.x - 2.0f * q.z * q.z,
-		2.0f * q.y * q.z - 2.0f * q.w * q.x,
-		0.0f,
-		2.0f * q.x * q.z - 2.0f * q.w * q.y,
-		2.0f * q.y * q.z + 2.0f * q.w * q.x,
-		1.0f - 2.0f * q.x * q.x - 2.0f * q.y * q.y,
-		1.0f}
-	{
-		// Nothing to do.
-	}
-
-	float Matrix4::operator[](std::size_t index) const
-	{
-		assert(index < 16);
-		return m[index];
-	}
-
 	bool operator==(const Matrix4& A, const Matrix4& B)
 	{
 		const float epsilon = 1e-6;
@@ -91,96 +26,6 @@ namespace M3D
 		return !(A == B);
 	}
 
-	Matrix4 operator+(const Matrix4& A, const Matrix4& B)
-	{
-		return Matrix4(
-			A[0] + B[0], A[1] + B[1], A[2] + B[2], A[3] + B[3],
-			A[4] + B[4], A[5] + B[5], A[6] + B[6], A[7] + B[7],
-			A[8] + B[8], A[9] + B[9], A[10] + B[10], A[11] + B[11],
-			A[12] + B[12], A[13] + B[13], A[14] + B[14], A[15] + B[15]
-		);
-	}
-
-	Matrix4 operator-(const Matrix4& lhs, const Matrix4& rhs)
-	{
-		return Matrix4(
-			lhs[0] - rhs[0], lhs[1] - rhs[1], lhs[2] - rhs[2], lhs[3] - rhs[3],
-			lhs[4] - rhs[4], lhs[5] - rhs[5], lhs[6] - rhs[6], lhs[7] - rhs[7],
-			lhs[8] - rhs[8], lhs[9] - rhs[9], lhs[10] - rhs[10], lhs[11] - rhs[11],
-			lhs[12] - rhs[12], lhs[13] - rhs[13], lhs[14] - rhs[14], lhs[15] - rhs[15]
-		);
-	}
-
-	Matrix4 operator-(const Matrix4& A)
-	{
-		return Matrix4(
-			-A[0], -A[1], -A[2], -A[3],
-			-A[4], -A[5], -A[6], -A[7],
-			-A[8], -A[9], -A[10], -A[11],
-			-A[12], -A[13], -A[14], -A[15]
-		);
-	}
-
-	Matrix4 operator*(const Matrix4& A, const float s)
-	{
-		return Matrix4(
-			A[0] * s, A[1] * s, A[2] * s, A[3] * s,
-			A[4] * s, A[5] * s, A[6] * s, A[7] * s,
-			A[8] * s, A[9] * s, A[10] * s, A[11] * s,
-			A[12] * s, A[13] * s, A[14] * s, A[15] * s
-		);
-	}
-
-	Matrix4 operator*(const float s, const Matrix4& A)
-	{
-		return A * s;
-	}
-
-	Vector4 operator*(const Matrix4& lhs, const Vector4& rhs)
-	{
-		return Vector4(
-			lhs[0] * rhs.x + lhs[1] * rhs.y + lhs[2] * rhs.z + lhs[3] * rhs.w,
-			lhs[4] * rhs.x + lhs[5] * rhs.y + lhs[6] * rhs.z + lhs[7] * rhs.w,
-			lhs[8] * rhs.x + lhs[9] * rhs.y + lhs[10] * rhs.z + lhs[11] * rhs.w,
-			lhs[12] * rhs.x + lhs[13] * rhs.y + lhs[14] * rhs.z + lhs[15] * rhs.w
-		);
-	}
-
-	Vector4 operator*(const Vector4& lhs, const Matrix4& rhs)
-	{
-		return Vector4(
-			lhs.x * rhs[0] + lhs.y * rhs[4] + lhs.z * rhs[8] + lhs.w * rhs[12],
-			lhs.x * rhs[1] + lhs.y * rhs[5] + lhs.z * rhs[9] + lhs.w * rhs[13],
-			lhs.x * rhs[2] + lhs.y * rhs[6] + lhs.z * rhs[10] + lhs.w * rhs[14],
-			lhs.x * rhs[3] + lhs.y * rhs[7] + lhs.z * rhs[11] + lhs.w * rhs[15]
-		);
-	}
-
-	Matrix4 operator*(const Matrix4& lhs, const Matrix4& rhs)
-	{
-		return Matrix4(
-			lhs[0] * rhs[0] + lhs[1] * rhs[4] + lhs[2] * rhs[8] + lhs[3] * rhs[12],
-			lhs[0] * rhs[1] + lhs[1] * rhs[5] + lhs[2] * rhs[9] + lhs[3] * rhs[13],
-			lhs[0] * rhs[2] + lhs[1] * rhs[6] + lhs[2] * rhs[10] + lhs[3] * rhs[14],
-			lhs[0] * rhs[3] + lhs[1] * rhs[7] + lhs[2] * rhs[11] + lhs[3] * rhs[15],
-
-			lhs[4] * rhs[0] + lhs[5] * rhs[4] + lhs[6] * rhs[8] + lhs[7] * rhs[12],
-			lhs[4] * rhs[1] + lhs[5] * rhs[5] + lhs[6] * rhs[9] + lhs[7] * rhs[13],
-			lhs[4] * rhs[2] + lhs[5] * rhs[6] + lhs[6] * rhs[10] + lhs[7] * rhs[14],
-			lhs[4] * rhs[3] + lhs[5] * rhs[7] + lhs[6] * rhs[11] + lhs[7] * rhs[15],
-
-			lhs[8] * rhs[0] + lhs[9] * rhs[4] + lhs[10] * rhs[8] + lhs[11] * rhs[12],
-			lhs[8] * rhs[1] + lhs[9] * rhs[5] + lhs[10] * rhs[9] + lhs[11] * rhs[13],
-			lhs[8] * rhs[2] + lhs[9] * rhs[6] + lhs[10] * rhs[10] + lhs[11] * rhs[14],
-			lhs[8] * rhs[3] + lhs[9] * rhs[7] + lhs[10] * rhs[11] + lhs[11] * rhs[15],
-
-			lhs[12] * rhs[0] + lhs[13] * rhs[4] + lhs[14] * rhs[8] + lhs[15] * rhs[12],
-			lhs[12] * rhs[1] + lhs[13] * rhs[5] + lhs[14] * rhs[9] + lhs[15] * rhs[13],
-			lhs[12] * rhs[2] + lhs[13] * rhs[6] + lhs[14] * rhs[10] + lhs[15] * rhs[14],
-			lhs[12] * rhs[3] + lhs[13] * rhs[7] + lhs[14] * rhs[11] + lhs[15] * rhs[15]
-		);
-	}
-
 	std::ostream& operator <<(std::ostream& out, const Matrix4& A)
 	{
 		std::string stringMatrix[16];
@@ -233,193 +78,95 @@ namespace M3D
 		return out;
 	}
 
-	Matrix4 Matrix4::transposed() const
+	Matrix4 Matrix4::inverse() const
 	{
-		return Matrix4(
-			m[0], m[4], m[8], m[12],
-			m[1], m[5], m[9], m[13],
-			m[2], m[6], m[10], m[14],
-			m[3], m[7], m[11], m[15]
-		);
+		float det;
+		return inverse(det);
 	}
 
-	void Matrix4::transpose()
+	Matrix4 Matrix4::inverse(float& det) const
 	{
-		std::swap(m[1], m[4]);
-		std::swap(m[2], m[8]);
-		std::swap(m[3], m[12]);
-		std::swap(m[6], m[9]);
-		std::swap(m[7], m[13]);
-		std::swap(m[11], m[14]);
-	}
+		float inv[16];
+		det = simd::inverseMatrix4(m, inv);
 
-	float Matrix4::determinant() const
-	{
-		const float det1 = m[10] * (m[15] * m[5] - m[7] * m[13]) + m[11] * (m[13] * m[6] - m[5] * m[14]) + m[9] * (m[14] * m[7] - m[6] * m[15]);
-		const float det2 = m[1] * (m[10] * m[15] - m[11] * m[14]) + m[2] * (m[11] * m[13] - m[9] * m[15]) + m[3] * (m[9] * m[14] - m[10] * m[13]);
-		const float det3 = m[1] * (m[6] * m[15] - m[7] * m[14]) + m[2] * (m[7] * m[13] - m[5] * m[15]) + m[3] * (m[5] * m[14] - m[6] * m[13]);
-		const float det4 = m[1] * (m[6] * m[11] - m[7] * m[10]) + m[2] * (m[7] * m[9] - m[5] * m[11]) + m[3] * (m[5] * m[10] - m[6] * m[9]);
+		// Ensure that the matrix is not singular.
+		assert(det != 0.0f);
 
-		return (m[0] * det1 - m[4] * det2 + m[8] * det3 - m[12] * det4);
+		return Matrix4(inv);
 	}
 
-	// Taken from the MESA implementation of the GLU library.
-	Matrix4 Matrix4::inverse() const
+	Matrix4 Matrix4::inverseAffine() const
 	{
-		float inv[16];
+		// The matrix must be of the form | M t |, as built by translation(),
+		//                                | 0 1 |
+		// scaling() and the rotation constructors. The inverse is then
+		// | inv(M) -inv(M)t |.
+		// |   0        1    |
+		assert(m[12] == 0.0f && m[13] == 0.0f && m[14] == 0.0f && m[15] == 1.0f);
 
-		inv[0] =	m[5]  * m[10] * m[15] -
-					m[5]  * m[11] * m[14] -
-					m[9]  * m[6]  * m[15] +
-					m[9]  * m[7]  * m[14] +
-					m[13] * m[6]  * m[11] -
-					m[13] * m[7]  * m[10];
-
-		inv[4] =   -m[4]  * m[10] * m[15] +
-					m[4]  * m[11] * m[14] +
-					m[8]  * m[6]  * m[15] -
-					m[8]  * m[7]  * m[14] -
-					m[12] * m[6]  * m[11] +
-					m[12] * m[7]  * m[10];
-
-		inv[8] =	m[4]  * m[9]  * m[15] -
-					m[4]  * m[11] * m[13] -
-					m[8]  * m[5]  * m[15] +
-					m[8]  * m[7]  * m[13] +
-					m[12] * m[5]  * m[11] -
-					m[12] * m[7]  * m[9];
-
-		inv[12] =  -m[4]  * m[9]  * m[14] +
-					m[4]  * m[10] * m[13] +
-					m[8]  * m[5]  * m[14] -
-					m[8]  * m[6]  * m[13] -
-					m[12] * m[5]  * m[10] +
-					m[12] * m[6]  * m[9];
-
-		inv[1] =   -m[1]  * m[10] * m[15] +
-					m[1]  * m[11] * m[14] +
-					m[9]  * m[2]  * m[15] -
-					m[9]  * m[3]  * m[14] -
-					m[13] * m[2]  * m[11] +
-					m[13] * m[3]  * m[10];
-
-		inv[5] =	m[0]  * m[10] * m[15] -
-					m[0]  * m[11] * m[14] -
-					m[8]  * m[2]  * m[15] +
-					m[8]  * m[3]  * m[14] +
-					m[12] * m[2]  * m[11] -
-					m[12] * m[3]  * m[10];
-
-		inv[9] =   -m[0]  * m[9]  * m[15] +
-					m[0]  * m[11] * m[13] +
-					m[8]  * m[1]  * m[15] -
-					m[8]  * m[3]  * m[13] -
-					m[12] * m[1]  * m[11] +
-					m[12] * m[3]  * m[9];
-
-		inv[13] =	m[0]  * m[9]  * m[14] -
-					m[0]  * m[10] * m[13] -
-					m[8]  * m[1]  * m[14] +
-					m[8]  * m[2]  * m[13] +
-					m[12] * m[1]  * m[10] -
-					m[12] * m[2]  * m[9];
-
-		inv[2] =	m[1]  * m[6]  * m[15] -
-					m[1]  * m[7]  * m[14] -
-					m[5]  * m[2]  * m[15] +
-					m[5]  * m[3]  * m[14] +
-					m[13] * m[2]  * m[7]  -
-					m[13] * m[3]  * m[6];
-
-		inv[6] =   -m[0]  * m[6]  * m[15] +
-					m[0]  * m[7]  * m[14] +
-					m[4]  * m[2]  * m[15] -
-					m[4]  * m[3]  * m[14] -
-					m[12] * m[2]  * m[7]  +
-					m[12] * m[3]  * m[6];
-
-		inv[10] =   m[0]  * m[5]  * m[15] -
-					m[0]  * m[7]  * m[13] -
-					m[4]  * m[1]  * m[15] +
-					m[4]  * m[3]  * m[13] +
-					m[12] * m[1]  * m[7]  -
-					m[12] * m[3]  * m[5];
-
-		inv[14] =  -m[0]  * m[5]  * m[14] +
-					m[0]  * m[6]  * m[13] +
-					m[4]  * m[1]  * m[14] -
-					m[4]  * m[2]  * m[13] -
-					m[12] * m[1]  * m[6]  +
-					m[12] * m[2]  * m[5];
-
-		inv[3] =   -m[1]  * m[6]  * m[11] +
-					m[1]  * m[7]  * m[10] +
-					m[5]  * m[2]  * m[11] -
-					m[5]  * m[3]  * m[10] -
-					m[9]  * m[2]  * m[7]  +
-					m[9]  * m[3]  * m[6];
-
-		inv[7] =	m[0]  * m[6]  * m[11] -
-					m[0]  * m[7]  * m[10] -
-					m[4]  * m[2]  * m[11] +
-					m[4]  * m[3]  * m[10] +
-					m[8]  * m[2]  * m[7]  -
-					m[8]  * m[3]  * m[6];
-
-		inv[11] =  -m[0]  * m[5]  * m[11] +
-					m[0]  * m[7]  * m[9]  +
-					m[4]  * m[1]  * m[11] -
-					m[4]  * m[3]  * m[9]  -
-					m[8]  * m[1]  * m[7]  +
-					m[8]  * m[3]  * m[5];
-
-		inv[15] =	m[0]  * m[5]  * m[10] -
-					m[0]  * m[6]  * m[9]  -
-					m[4]  * m[1]  * m[10] +
-					m[4]  * m[2]  * m[9]  +
-					m[8]  * m[1]  * m[6]  -
-					m[8]  * m[2]  * m[5];
-
-		// Determinant.
-		const float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+		// Cofactors of the upper 3x3 block M.
+		const float c00 = m[5] * m[10] - m[6] * m[9];
+		const float c01 = m[6] * m[8] - m[4] * m[10];
+		const float c02 = m[4] * m[9] - m[5] * m[8];
+
+		const float det = m[0] * c00 + m[1] * c01 + m[2] * c02;
 
 		// Ensure that the matrix is not singular.
 		assert(det != 0.0f);
 
-		// Return a copy of the inverse of this matrix.
 		const float invDet = 1.0f / det;
-		for (std::size_t i = 0; i < 16; ++i) inv[i] *= invDet;
-		return Matrix4(inv);
-	}
 
-	Matrix4 Matrix4::scaling(const Vector3& scaleFactors)
-	{
+		const float i00 = c00 * invDet;
+		const float i01 = (m[2] * m[9] - m[1] * m[10]) * invDet;
+		const float i02 = (m[1] * m[6] - m[2] * m[5]) * invDet;
+		const float i10 = c01 * invDet;
+		const float i11 = (m[0] * m[10] - m[2] * m[8]) * invDet;
+		const float i12 = (m[2] * m[4] - m[0] * m[6]) * invDet;
+		const float i20 = c02 * invDet;
+		const float i21 = (m[1] * m[8] - m[0] * m[9]) * invDet;
+		const float i22 = (m[0] * m[5] - m[1] * m[4]) * invDet;
+
 		return Matrix4(
-			scaleFactors.x, 0.0f, 0.0f, 0.0f,
-			0.0f, scaleFactors.y, 0.0f, 0.0f,
-			0.0f, 0.0f, scaleFactors.z, 0.0f,
+			i00, i01, i02, -(i00 * m[3] + i01 * m[7] + i02 * m[11]),
+			i10, i11, i12, -(i10 * m[3] + i11 * m[7] + i12 * m[11]),
+			i20, i21, i22, -(i20 * m[3] + i21 * m[7] + i22 * m[11]),
 			0.0f, 0.0f, 0.0f, 1.0f
 		);
 	}
 
-	Matrix4 Matrix4::scaling(const float factor)
+	Matrix4 Matrix4::inverseRigid() const
 	{
+		// As inverseAffine(), but M must also be a pure rotation, so its
+		// inverse is simply its transpose.
+		assert(m[12] == 0.0f && m[13] == 0.0f && m[14] == 0.0f && m[15] == 1.0f);
+
 		return Matrix4(
-			factor, 0.0f, 0.0f, 0.0f,
-			0.0f, factor, 0.0f, 0.0f,
-			0.0f, 0.0f, factor, 0.0f,
+			m[0], m[4], m[8], -(m[0] * m[3] + m[4] * m[7] + m[8] * m[11]),
+			m[1], m[5], m[9], -(m[1] * m[3] + m[5] * m[7] + m[9] * m[11]),
+			m[2], m[6], m[10], -(m[2] * m[3] + m[6] * m[7] + m[10] * m[11]),
 			0.0f, 0.0f, 0.0f, 1.0f
 		);
 	}
 
-	Matrix4 Matrix4::translation(const Vector3& translation)
+	void Matrix4::frustumPlanes(Vector4 planes[6]) const
 	{
-		return Matrix4(
-			1.0f, 0.0f, 0.0f, translation.x,
-			0.0f, 1.0f, 0.0f, translation.y,
-			0.0f, 0.0f, 1.0f, translation.z,
-			0.0f, 0.0f, 0.0f, 1.0f
-		);
+		// Gribb and Hartmann: -w <= x <= w for a clip space point
+		// (x, y, z, w) = M * p gives the planes row3 + row0 >= 0 and
+		// row3 - row0 >= 0, and likewise for y and z.
+		for (std::size_t i = 0; i < 6; ++i)
+		{
+			const std::size_t row = 4 * (i / 2);
+			const float sign = i % 2 == 0 ? 1.0f : -1.0f;
+			const Vector4 plane(
+				m[12] + sign * m[row + 0],
+				m[13] + sign * m[row + 1],
+				m[14] + sign * m[row + 2],
+				m[15] + sign * m[row + 3]
+			);
+			const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+			assert(length != 0.0f);
+			planes[i] = plane / length;
+		}
 	}
 
 	Matrix4 Matrix4::angleAxis(const float angle, const Vector3& axis)
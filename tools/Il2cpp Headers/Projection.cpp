@@ -0,0 +1,140 @@
+#include <M3D/Matrix4.hpp>
+#include <M3D/Projection.hpp>
+#include <M3D/Simd.hpp>
+#include <M3D/UnityMatrix4.hpp>
+#include <M3D/Vector2.hpp>
+#include <M3D/Vector3.hpp>
+#include <Rect.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace M3D
+{
+	namespace
+	{
+		static_assert(sizeof(Vector2) == 2 * sizeof(float), "Vector2 must be 2 packed floats");
+		static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be 3 packed floats");
+
+		// Moves bit k of a four lane mask to the lowest bit of byte k, which
+		// is lane k of the flags once stored in memory order.
+		inline std::uint32_t spreadBits(const unsigned int mask)
+		{
+			std::uint8_t bytes[4] = {
+				static_cast<std::uint8_t>(mask & 1u), static_cast<std::uint8_t>((mask >> 1) & 1u),
+				static_cast<std::uint8_t>((mask >> 2) & 1u), static_cast<std::uint8_t>((mask >> 3) & 1u)};
+			std::uint32_t spread;
+			std::memcpy(&spread, bytes, sizeof(spread));
+			return spread;
+		}
+
+		// The entries of the view-projection matrix and the viewport
+		// transform, broadcast into registers once per call.
+		struct Projector
+		{
+			simd::float4 m[16];
+			simd::float4 centerX, centerY, halfWidth, halfHeight;
+
+			// Entry (row, column) of the matrix is a[row * rowStride +
+			// column * columnStride].
+			Projector(const float* a, const std::size_t rowStride, const std::size_t columnStride, const Rect& viewport,
+				const ScreenOrigin origin)
+			{
+				for (unsigned int i = 0; i < 16; ++i) m[i] = simd::splat(a[i / 4 * rowStride + i % 4 * columnStride]);
+
+				centerX = simd::splat(viewport.x + 0.5f * viewport.width);
+				centerY = simd::splat(viewport.y + 0.5f * viewport.height);
+				halfWidth = simd::splat(0.5f * viewport.width);
+				halfHeight = simd::splat(origin == ScreenOrigin::TopLeft ? -0.5f * viewport.height : 0.5f * viewport.height);
+			}
+
+			// Projects the four packed positions at p. Returns the mask of the
+			// lanes with no flag set.
+			unsigned int project4(const float* p, float* screen, float* depth, std::uint8_t* flags) const
+			{
+				using namespace simd;
+
+				float4 x, y, z;
+				loadInterleaved3(p, x, y, z);
+
+				const float4 cx = madd(m[2], z, madd(m[1], y, madd(m[0], x, m[3])));
+				const float4 cy = madd(m[6], z, madd(m[5], y, madd(m[4], x, m[7])));
+				const float4 cz = madd(m[10], z, madd(m[9], y, madd(m[8], x, m[11])));
+				const float4 cw = madd(m[14], z, madd(m[13], y, madd(m[12], x, m[15])));
+				const float4 zero = splat(0.0f);
+				const float4 minusW = sub(zero, cw);
+
+				// Inside is -w <= c <= w on each axis, tested in clip space so
+				// the tests do not wait for the divide. NaN positions fail
+				// none of them.
+				const mask4 ahead = greaterThan(cw, zero);
+				const unsigned int behind = ~moveMask(ahead) & 15u;
+				const unsigned int outside = (moveMask(greaterThan(cx, cw)) | moveMask(greaterThan(minusW, cx))
+					| moveMask(greaterThan(cy, cw)) | moveMask(greaterThan(minusW, cy))) & ~behind;
+				const unsigned int clipped = (moveMask(greaterThan(cz, cw)) | moveMask(greaterThan(minusW, cz))) & ~behind;
+
+				// Lanes behind the camera divide by 1 instead, so that they
+				// stay finite.
+				const float4 invW = div(splat(1.0f), select(ahead, cw, splat(1.0f)));
+				const float4 sx = madd(mul(cx, invW), halfWidth, centerX);
+				const float4 sy = madd(mul(cy, invW), halfHeight, centerY);
+				storeInterleaved2(screen, sx, sy);
+				store(depth, cw);
+
+				const std::uint32_t laneFlags = spreadBits(behind) * ProjectionFlags::BEHIND_CAMERA
+					| spreadBits(outside) * ProjectionFlags::OUTSIDE_VIEWPORT
+					| spreadBits(clipped) * ProjectionFlags::DEPTH_CLIPPED;
+				std::memcpy(flags, &laneFlags, sizeof(laneFlags));
+				return ~(behind | outside | clipped) & 15u;
+			}
+		};
+
+		unsigned int countBits(unsigned int mask)
+		{
+			return (mask & 1u) + ((mask >> 1) & 1u) + ((mask >> 2) & 1u) + ((mask >> 3) & 1u);
+		}
+
+		std::size_t projectAll(const Projector& projector, const Vector3* positions, const std::size_t count,
+			Vector2* screen, float* depth, std::uint8_t* flags)
+		{
+			std::size_t visible = 0;
+			std::size_t i = 0;
+			for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+			{
+				visible += countBits(projector.project4(&positions[i].x, &screen[i].x, depth + i, flags + i));
+			}
+
+			// The remaining positions are padded to a full group so that they
+			// go through the same arithmetic.
+			if (i < count)
+			{
+				const std::size_t rest = count - i;
+				Vector3 paddedPositions[simd::WIDTH];
+				Vector2 paddedScreen[simd::WIDTH];
+				float paddedDepth[simd::WIDTH];
+				std::uint8_t paddedFlags[simd::WIDTH];
+				std::copy(positions + i, positions + count, paddedPositions);
+				const unsigned int mask = projector.project4(&paddedPositions[0].x, &paddedScreen[0].x, paddedDepth, paddedFlags);
+				visible += countBits(mask & ((1u << rest) - 1u));
+				std::copy(paddedScreen, paddedScreen + rest, screen + i);
+				std::copy(paddedDepth, paddedDepth + rest, depth + i);
+				std::copy(paddedFlags, paddedFlags + rest, flags + i);
+			}
+			return visible;
+		}
+	}
+
+	std::size_t project(const Matrix4& viewProjection, const Vector3* positions, const std::size_t count,
+		const Rect& viewport, Vector2* screen, float* depth, std::uint8_t* flags, const ScreenOrigin origin)
+	{
+		const Projector projector(viewProjection.data(), 4, 1, viewport, origin);
+		return projectAll(projector, positions, count, screen, depth, flags);
+	}
+
+	std::size_t project(const UnityMatrix4& viewProjection, const Vector3* positions, const std::size_t count,
+		const Rect& viewport, Vector2* screen, float* depth, std::uint8_t* flags, const ScreenOrigin origin)
+	{
+		const Projector projector(viewProjection.data(), 1, 4, viewport, origin);
+		return projectAll(projector, positions, count, screen, depth, flags);
+	}
+}
@@ -1,40 +1,12 @@
 #include <M3D/Quaternion.hpp>
 #include <M3D/Vector3.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 
 namespace M3D
 {
-	const Quaternion Quaternion::IDENTITY = Quaternion(1.0f, 0.0f, 0.0f, 0.0f);
-
-	Quaternion::Quaternion()
-	: w(1.0f)
-	, x(0.0f)
-	, y(0.0f)
-	, z(0.0f)
-	{
-		// Nothing to do.
-	}
-
-	Quaternion::Quaternion(float w_, float x_, float y_, float z_)
-	: w(w_)
-	, x(x_)
-	, y(y_)
-	, z(z_)
-	{
-		// Nothing to do.
-	}
-
-	Quaternion::Quaternion(const float s, const Vector3& v)
-	: w(s)
-	, x(v.x)
-	, y(v.y)
-	, z(v.z)
-	{
-		// Nothing to do.
-	}
-
 	float operator==(const Quaternion& q1, const Quaternion& q2)
 	{
 		const float epsilon = 1e-6;
@@ -47,52 +19,13 @@ namespace M3D
 		return !(q1 == q2);
 	}
 
-	Quaternion operator*(const Quaternion& lhs, const Quaternion& rhs)
-	{
-		return Quaternion(
-			lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z,
-			lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
-			lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
-			lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w
-		);
-	}
-
-	Vector3 operator*(const Quaternion& q, const Vector3& v)
-	{
-		// Quaternion r = q * Quaternion(0.0f, v.x, v.y, v.z) * q.conjugate();
-		// return Vector3(r.x, r.y, r.z);
-
-		// This faster method is described:
-		// http://molecularmusings.wordpress.com/2013/05/24/a-faster-quaternion-vector-multiplication/
-		const Vector3 qv = Vector3(q.x, q.y, q.z);
-		const Vector3 t = 2.0f * cross(qv, v);
-		return v + q.w * t + cross(qv, t);
-	}
-
 	std::ostream& operator <<(std::ostream& out, const Quaternion& q)
 	{
 		out << q.w << " + " << q.x << "i + " << q.y << "j + " << q.z << "k";
 		return out;
 	}
 
-	float Quaternion::sqrMagnitude() const
-	{
-		return w * w + x * x + y * y + z * z;
-	}
-
-	float Quaternion::magnitude() const
-	{
-		return sqrt(sqrMagnitude());
-	}
-
-	Quaternion Quaternion::normalized() const
-	{
-		assert(magnitude() > 0.0f);
-		const float invNorm = 1.0f / magnitude();
-
-		return Quaternion(w * invNorm, x * invNorm, y * invNorm, z * invNorm);
-	}
-
+	template <Precision P>
 	void Quaternion::rotateTowards(const Quaternion& target, float maxRadiansDelta)
 	{
 		// Relative unit quaternion rotation between this quaternion and the
@@ -101,7 +34,7 @@ namespace M3D
 
 		// Calculate the angle and axis of the relative quaternion rotation.
 		assert(std::abs(relativeRotation.w) <= 1.0f);
-		const float angle = 2.0f * std::acos(relativeRotation.w);
+		const float angle = 2.0f * Math<P>::acos(relativeRotation.w);
 		const Vector3 axis(relativeRotation.x, relativeRotation.y, relativeRotation.z);
 
 		// Apply a step of the relative rotation.
@@ -112,7 +45,7 @@ namespace M3D
 			// maxRadiansDelta. Note that we need to normalize the axis as the
 			// vector part of the relativeRotation quaternion is probably not
 			// a unit vector (unless the scalar part is zero).
-			const Quaternion delta = Quaternion::angleAxis(maxRadiansDelta, axis.normalized());
+			const Quaternion delta = Quaternion::angleAxis<P>(maxRadiansDelta, axis.normalized<P>());
 			(*this) = delta * (*this);
 		}
 		else
@@ -122,39 +55,36 @@ namespace M3D
 		}
 	}
 
-	void Quaternion::normalize()
-	{
-		assert(magnitude() > 0.0f);
-		const float invNorm = 1.0f / magnitude();
-
-		w *= invNorm;
-		x *= invNorm;
-		y *= invNorm;
-		z *= invNorm;
-	}
+	template void Quaternion::rotateTowards<Precision::Exact>(const Quaternion&, float);
+	template void Quaternion::rotateTowards<Precision::Fast>(const Quaternion&, float);
 
+	template <Precision P>
 	Quaternion Quaternion::angleAxis(const float angle, const Vector3& axis)
 	{
 		// The axis supplied should be a unit vector. We don't automatically
-		// normalize the axis for efficiency.
-		assert(std::abs(axis.magnitude() - 1.0f) < 1e-6);
+		// normalize the axis for efficiency. Axes normalized with
+		// Precision::Fast are only within about 5e-6 of unit length.
+		assert(std::abs(axis.magnitude() - 1.0f) < (P == Precision::Exact ? 1e-6 : 1e-5));
 
-		const float halfAngle = 0.5f * angle;
-		return Quaternion(std::cos(halfAngle), axis * std::sin(halfAngle));
+		float sinHalfAngle, cosHalfAngle;
+		Math<P>::sinCos(0.5f * angle, sinHalfAngle, cosHalfAngle);
+		return Quaternion(cosHalfAngle, axis * sinHalfAngle);
 	}
 
+	template Quaternion Quaternion::angleAxis<Precision::Exact>(const float, const Vector3&);
+	template Quaternion Quaternion::angleAxis<Precision::Fast>(const float, const Vector3&);
+
+	template <Precision P>
 	Quaternion Quaternion::euler(const Vector3& eulerAngles)
 	{
 		const float halfPhi = 0.5f * eulerAngles.x; // Half the roll.
 		const float halfTheta = 0.5f * eulerAngles.y; // Half the pitch.
 		const float halfPsi = 0.5f * eulerAngles.z; // Half the yaw.
 
-		const float cosHalfPhi = std::cos(halfPhi);
-		const float sinHalfPhi = std::sin(halfPhi);
-		const float cosHalfTheta = std::cos(halfTheta);
-		const float sinHalfTheta = std::sin(halfTheta);
-		const float cosHalfPsi = std::cos(halfPsi);
-		const float sinHalfPsi = std::sin(halfPsi);
+		float cosHalfPhi, sinHalfPhi, cosHalfTheta, sinHalfTheta, cosHalfPsi, sinHalfPsi;
+		Math<P>::sinCos(halfPhi, sinHalfPhi, cosHalfPhi);
+		Math<P>::sinCos(halfTheta, sinHalfTheta, cosHalfTheta);
+		Math<P>::sinCos(halfPsi, sinHalfPsi, cosHalfPsi);
 
 		return Quaternion(
 			cosHalfPhi * cosHalfTheta * cosHalfPsi - sinHalfPhi * sinHalfTheta * sinHalfPsi,
@@ -164,6 +94,9 @@ namespace M3D
 		);
 	}
 
+	template Quaternion Quaternion::euler<Precision::Exact>(const Vector3&);
+	template Quaternion Quaternion::euler<Precision::Fast>(const Vector3&);
+
 	Quaternion Quaternion::fromToRotation(const Vector3& fromDirection, const Vector3& toDirection)
 	{
 		assert(fromDirection.sqrMagnitude() > 0.0f && toDirection.sqrMagnitude() > 0.0f);
@@ -244,29 +177,68 @@ namespace M3D
 		return q2 * q1;
 	}
 
-	Quaternion Quaternion::conjugate() const
+	template <Precision P>
+	float angle(const Quaternion& from, const Quaternion& to)
 	{
-		return Quaternion(w, -x, -y, -z);
+		const Quaternion relativeRotation = from.conjugate() * to;
+		assert(std::abs(relativeRotation.w) <= 1.0f);
+		return 2.0f * Math<P>::acos(relativeRotation.w);
 	}
 
-	Quaternion Quaternion::inverse() const
-	{
-		const float sqr = sqrMagnitude();
-		assert(sqr > 0.0f);
+	template float angle<Precision::Exact>(const Quaternion&, const Quaternion&);
+	template float angle<Precision::Fast>(const Quaternion&, const Quaternion&);
 
-		const float invSqr = 1.0f / sqr;
-		return Quaternion(w * invSqr, -x * invSqr, -y * invSqr, -z * invSqr);
+	namespace
+	{
+		// from * s0 + to * s1, normalized.
+		template <Precision P>
+		inline Quaternion blend(const Quaternion& from, const Quaternion& to, const float s0, const float s1)
+		{
+			return Quaternion(
+				from.w * s0 + to.w * s1,
+				from.x * s0 + to.x * s1,
+				from.y * s0 + to.y * s1,
+				from.z * s0 + to.z * s1
+			).normalized<P>();
+		}
 	}
 
-	float dot(const Quaternion& lhs, const Quaternion& rhs)
+	template <Precision P>
+	Quaternion slerp(const Quaternion& from, const Quaternion& to, float t)
 	{
-		return lhs.w * rhs.w + lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
+		// cos of half the angle between the rotations. A negative one means
+		// that -to, the same rotation, is on the shorter arc.
+		const float cosHalfAngle = dot(from, to);
+		const float sign = cosHalfAngle < 0.0f ? -1.0f : 1.0f;
+		const float c = std::min(std::abs(cosHalfAngle), 1.0f);
+
+		// Within 3.6 degrees sin(k a) / sin(a), for half the angle a, is
+		// k (1 - (k^2 - 1) a^2 / 6) to float precision, with a^2 = 2 (1 - c),
+		// and the sines would lose precision. c > cos(1.8 degrees).
+		if (c > 0.999507f)
+		{
+			const float a2 = 2.0f * (1.0f - c);
+			const float u = 1.0f - t;
+			return blend<P>(from, to, u * (1.0f - (u * u - 1.0f) * a2 * (1.0f / 6.0f)),
+				sign * t * (1.0f - (t * t - 1.0f) * a2 * (1.0f / 6.0f)));
+		}
+
+		const float halfAngle = Math<P>::acos(c);
+		const float invSin = Math<P>::rsqrt(1.0f - c * c);
+		return blend<P>(from, to, Math<P>::sin((1.0f - t) * halfAngle) * invSin,
+			sign * Math<P>::sin(t * halfAngle) * invSin);
 	}
 
-	float angle(const Quaternion& from, const Quaternion& to)
+	template Quaternion slerp<Precision::Exact>(const Quaternion&, const Quaternion&, float);
+	template Quaternion slerp<Precision::Fast>(const Quaternion&, const Quaternion&, float);
+
+	template <Precision P>
+	Quaternion nlerp(const Quaternion& from, const Quaternion& to, float t)
 	{
-		const Quaternion relativeRotation = from.conjugate() * to;
-		assert(std::abs(relativeRotation.w) <= 1.0f);
-		return 2.0f * std::acos(relativeRotation.w);
+		const float sign = dot(from, to) < 0.0f ? -1.0f : 1.0f;
+		return blend<P>(from, to, 1.0f - t, sign * t);
 	}
+
+	template Quaternion nlerp<Precision::Exact>(const Quaternion&, const Quaternion&, float);
+	template Quaternion nlerp<Precision::Fast>(const Quaternion&, const Quaternion&, float);
 }
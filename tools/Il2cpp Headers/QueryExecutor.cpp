@@ -0,0 +1,104 @@
+#include <M3D/QueryExecutor.hpp>
+#include <M3D/ThreadPool.hpp>
+#include <M3D/Vector3.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace M3D
+{
+	QueryExecutor::QueryExecutor(ThreadPool& pool_, std::size_t grain_)
+	: pool(pool_)
+	, grain(grain_)
+	{
+		assert(grain_ > 0);
+	}
+
+	void QueryExecutor::queryRadius(const SpatialGrid& grid, const Vector3* centers, const float* radii,
+		std::size_t count, QueryResults<std::uint32_t>& out)
+	{
+		run(count, out, indexBuffers, [&](const std::size_t i, std::vector<std::uint32_t>& buffer, unsigned int)
+		{
+			grid.queryRadius(centers[i], radii[i], buffer);
+		});
+	}
+
+	void QueryExecutor::queryRadius(const SpatialGrid& grid, const Vector3* centers, float radius,
+		std::size_t count, QueryResults<std::uint32_t>& out)
+	{
+		run(count, out, indexBuffers, [&](const std::size_t i, std::vector<std::uint32_t>& buffer, unsigned int)
+		{
+			grid.queryRadius(centers[i], radius, buffer);
+		});
+	}
+
+	void QueryExecutor::queryBox(const SpatialGrid& grid, const Vector3* min, const Vector3* max,
+		std::size_t count, QueryResults<std::uint32_t>& out)
+	{
+		run(count, out, indexBuffers, [&](const std::size_t i, std::vector<std::uint32_t>& buffer, unsigned int)
+		{
+			grid.queryBox(min[i], max[i], buffer);
+		});
+	}
+
+	void QueryExecutor::queryNearest(const SpatialGrid& grid, const Vector3* points, std::size_t count,
+		std::size_t k, QueryResults<SpatialGrid::Neighbor>& out, float maxDistance)
+	{
+		// queryNearest() replaces its output, so each worker collects into
+		// a scratch vector first.
+		neighborScratch.resize(pool.size());
+		run(count, out, neighborBuffers, [&](const std::size_t i, std::vector<SpatialGrid::Neighbor>& buffer,
+			const unsigned int worker)
+		{
+			std::vector<SpatialGrid::Neighbor>& scratch = neighborScratch[worker];
+			grid.queryNearest(points[i], k, scratch, maxDistance);
+			buffer.insert(buffer.end(), scratch.begin(), scratch.end());
+		});
+	}
+
+	void QueryExecutor::nearest(const SpatialGrid& grid, const Vector3* points, std::size_t count,
+		std::uint32_t* nearest, float maxDistance)
+	{
+		pool.parallelFor(count, grain, [&](const std::size_t begin, const std::size_t end, unsigned int)
+		{
+			for (std::size_t i = begin; i < end; ++i) nearest[i] = grid.nearest(points[i], maxDistance);
+		});
+	}
+
+	template <typename T, typename Query>
+	void QueryExecutor::run(std::size_t count, QueryResults<T>& out, std::vector<std::vector<T>>& buffers, Query query)
+	{
+		buffers.resize(pool.size());
+		for (std::vector<T>& buffer : buffers) buffer.clear();
+		starts.resize(count);
+		owners.resize(count);
+		out.offsets.resize(count + 1);
+		out.offsets[0] = 0;
+
+		// offsets[i + 1] holds the number of results of query i until the
+		// prefix sum below.
+		pool.parallelFor(count, grain, [&](const std::size_t begin, const std::size_t end, const unsigned int worker)
+		{
+			std::vector<T>& buffer = buffers[worker];
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				starts[i] = buffer.size();
+				owners[i] = worker;
+				query(i, buffer, worker);
+				out.offsets[i + 1] = buffer.size() - starts[i];
+			}
+		});
+
+		for (std::size_t i = 0; i < count; ++i) out.offsets[i + 1] += out.offsets[i];
+		out.items.resize(out.offsets[count]);
+
+		pool.parallelFor(count, grain, [&](const std::size_t begin, const std::size_t end, unsigned int)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				const T* first = buffers[owners[i]].data() + starts[i];
+				std::copy(first, first + (out.offsets[i + 1] - out.offsets[i]), out.items.begin() + out.offsets[i]);
+			}
+		});
+	}
+}
@@ -0,0 +1,424 @@
+#include <M3D/SpatialGrid.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace M3D
+{
+	namespace
+	{
+		// Cell coordinates are clamped to 21 bits each so that a cell packs
+		// into a 63-bit key; DEAD has the top bit set and matches no cell.
+		const std::int32_t CELL_LIMIT = (1 << 20) - 1;
+		const std::uint64_t DEAD = ~std::uint64_t(0);
+
+		std::int32_t cellCoordinate(const float v)
+		{
+			const float c = std::floor(v);
+			if (c >= float(CELL_LIMIT)) return CELL_LIMIT;
+			if (c > -float(CELL_LIMIT)) return static_cast<std::int32_t>(c);
+			return -CELL_LIMIT;
+		}
+
+		// Points moved out of their cell that trigger a rebuild.
+		std::size_t movedLimit(const std::size_t count)
+		{
+			return std::max<std::size_t>(32, count / 8);
+		}
+
+		bool lessNeighbor(const SpatialGrid::Neighbor& a, const SpatialGrid::Neighbor& b)
+		{
+			return a.sqrDistance < b.sqrDistance || (a.sqrDistance == b.sqrDistance && a.index < b.index);
+		}
+	}
+
+	const std::uint32_t SpatialGrid::NONE = ~std::uint32_t(0);
+
+	SpatialGrid::SpatialGrid(float cellSize)
+	: edge(cellSize)
+	, inverseEdge(1.0f / cellSize)
+	, bucketStart(2, 0)
+	, lowest{0, 0, 0}
+	, highest{-1, -1, -1}
+	, mask(0)
+	{
+		assert(cellSize > 0.0f);
+	}
+
+	void SpatialGrid::setCellSize(float cellSize)
+	{
+		assert(cellSize > 0.0f);
+		edge = cellSize;
+		inverseEdge = 1.0f / cellSize;
+	}
+
+	float SpatialGrid::cellSize() const
+	{
+		return edge;
+	}
+
+	void SpatialGrid::build(const Vector3* points_, std::size_t count)
+	{
+		points.assign(points_, points_ + count);
+		rebuild();
+	}
+
+	void SpatialGrid::build(const float* xyz, std::size_t count, std::size_t strideBytes)
+	{
+		points.resize(count);
+		const unsigned char* p = reinterpret_cast<const unsigned char*>(xyz);
+		for (std::size_t i = 0; i < count; ++i, p += strideBytes)
+		{
+			float v[3];
+			std::memcpy(v, p, sizeof(v));
+			points[i] = Vector3(v[0], v[1], v[2]);
+		}
+		rebuild();
+	}
+
+	void SpatialGrid::update(std::uint32_t index, const Vector3& position)
+	{
+		assert(index < points.size());
+		points[index] = position;
+
+		const std::uint64_t key = keyOf(cellOf(position));
+		const std::uint32_t slot = slots[index];
+		if (key == pointKeys[index])
+		{
+			if (slot != NONE)
+			{
+				xs[slot] = position.x;
+				ys[slot] = position.y;
+				zs[slot] = position.z;
+			}
+			return;
+		}
+
+		pointKeys[index] = key;
+		if (slot != NONE)
+		{
+			keys[slot] = DEAD;
+			slots[index] = NONE;
+			moved.push_back(index);
+			if (moved.size() > movedLimit(points.size())) rebuild();
+		}
+	}
+
+	std::size_t SpatialGrid::size() const
+	{
+		return points.size();
+	}
+
+	bool SpatialGrid::empty() const
+	{
+		return points.empty();
+	}
+
+	Vector3 SpatialGrid::position(std::uint32_t index) const
+	{
+		assert(index < points.size());
+		return points[index];
+	}
+
+	std::size_t SpatialGrid::queryRadius(const Vector3& center, float radius, std::vector<std::uint32_t>& out) const
+	{
+		const std::size_t first = out.size();
+		if (!(radius >= 0.0f)) return 0;
+
+		const float r2 = radius * radius;
+		auto test = [&](const std::uint32_t index, const float x, const float y, const float z)
+		{
+			const float dx = x - center.x, dy = y - center.y, dz = z - center.z;
+			if (dx * dx + dy * dy + dz * dz <= r2) out.push_back(index);
+		};
+
+		const Cell lo = cellOf(center - Vector3(radius, radius, radius));
+		const Cell hi = cellOf(center + Vector3(radius, radius, radius));
+		const double cells = (double(hi.x) - lo.x + 1) * (double(hi.y) - lo.y + 1) * (double(hi.z) - lo.z + 1);
+		if (cells > double(xs.size()))
+		{
+			// Fewer points than cells to visit: test them all.
+			for (std::size_t s = 0; s < xs.size(); ++s)
+			{
+				if (keys[s] != DEAD) test(indices[s], xs[s], ys[s], zs[s]);
+			}
+		}
+		else
+		{
+			for (std::int32_t x = std::max(lo.x, lowest.x); x <= std::min(hi.x, highest.x); ++x)
+			for (std::int32_t y = std::max(lo.y, lowest.y); y <= std::min(hi.y, highest.y); ++y)
+			for (std::int32_t z = std::max(lo.z, lowest.z); z <= std::min(hi.z, highest.z); ++z)
+			{
+				forEachInCell(Cell{x, y, z}, [&](const std::size_t s) { test(indices[s], xs[s], ys[s], zs[s]); });
+			}
+		}
+
+		for (const std::uint32_t index : moved)
+		{
+			const Vector3& p = points[index];
+			test(index, p.x, p.y, p.z);
+		}
+		return out.size() - first;
+	}
+
+	std::size_t SpatialGrid::queryBox(const Vector3& min, const Vector3& max, std::vector<std::uint32_t>& out) const
+	{
+		const std::size_t first = out.size();
+		auto test = [&](const std::uint32_t index, const float x, const float y, const float z)
+		{
+			if (x >= min.x && x <= max.x && y >= min.y && y <= max.y && z >= min.z && z <= max.z) out.push_back(index);
+		};
+
+		const Cell lo = cellOf(min);
+		const Cell hi = cellOf(max);
+		const double cells = (double(hi.x) - lo.x + 1) * (double(hi.y) - lo.y + 1) * (double(hi.z) - lo.z + 1);
+		if (cells > double(xs.size()))
+		{
+			for (std::size_t s = 0; s < xs.size(); ++s)
+			{
+				if (keys[s] != DEAD) test(indices[s], xs[s], ys[s], zs[s]);
+			}
+		}
+		else
+		{
+			for (std::int32_t x = std::max(lo.x, lowest.x); x <= std::min(hi.x, highest.x); ++x)
+			for (std::int32_t y = std::max(lo.y, lowest.y); y <= std::min(hi.y, highest.y); ++y)
+			for (std::int32_t z = std::max(lo.z, lowest.z); z <= std::min(hi.z, highest.z); ++z)
+			{
+				forEachInCell(Cell{x, y, z}, [&](const std::size_t s) { test(indices[s], xs[s], ys[s], zs[s]); });
+			}
+		}
+
+		for (const std::uint32_t index : moved)
+		{
+			const Vector3& p = points[index];
+			test(index, p.x, p.y, p.z);
+		}
+		return out.size() - first;
+	}
+
+	void SpatialGrid::queryNearest(const Vector3& p, std::size_t k, std::vector<Neighbor>& out, float maxDistance) const
+	{
+		out.clear();
+		if (k == 0 || !(maxDistance >= 0.0f)) return;
+
+		// out is a max-heap on (sqrDistance, index) while searching, so that
+		// its front is the candidate to drop.
+		const float limit = maxDistance * maxDistance;
+		searchNearest(p,
+			[&](const std::uint32_t index, const float d2)
+			{
+				const Neighbor n = {index, d2};
+				if (d2 > limit) return;
+				if (out.size() < k)
+				{
+					out.push_back(n);
+					std::push_heap(out.begin(), out.end(), lessNeighbor);
+				}
+				else if (lessNeighbor(n, out.front()))
+				{
+					std::pop_heap(out.begin(), out.end(), lessNeighbor);
+					out.back() = n;
+					std::push_heap(out.begin(), out.end(), lessNeighbor);
+				}
+			},
+			[&]() { return out.size() < k ? limit : out.front().sqrDistance; });
+		std::sort_heap(out.begin(), out.end(), lessNeighbor);
+	}
+
+	std::uint32_t SpatialGrid::nearest(const Vector3& p, float maxDistance) const
+	{
+		if (!(maxDistance >= 0.0f)) return NONE;
+
+		Neighbor best = {NONE, maxDistance * maxDistance};
+		searchNearest(p,
+			[&](const std::uint32_t index, const float d2)
+			{
+				const Neighbor n = {index, d2};
+				if (d2 < best.sqrDistance || (d2 == best.sqrDistance && lessNeighbor(n, best))) best = n;
+			},
+			[&]() { return best.sqrDistance; });
+		return best.index;
+	}
+
+	SpatialGrid::Cell SpatialGrid::cellOf(const Vector3& p) const
+	{
+		return Cell{cellCoordinate(p.x * inverseEdge), cellCoordinate(p.y * inverseEdge), cellCoordinate(p.z * inverseEdge)};
+	}
+
+	std::uint64_t SpatialGrid::keyOf(const Cell& c)
+	{
+		const std::uint64_t bias = std::uint64_t(1) << 20;
+		return ((std::uint64_t(c.x) + bias) << 42) | ((std::uint64_t(c.y) + bias) << 21) | (std::uint64_t(c.z) + bias);
+	}
+
+	SpatialGrid::Cell SpatialGrid::cellOfKey(std::uint64_t key)
+	{
+		const std::int64_t bias = std::int64_t(1) << 20;
+		const std::uint64_t bits = (std::uint64_t(1) << 21) - 1;
+		return Cell{static_cast<std::int32_t>(std::int64_t((key >> 42) & bits) - bias),
+			static_cast<std::int32_t>(std::int64_t((key >> 21) & bits) - bias),
+			static_cast<std::int32_t>(std::int64_t(key & bits) - bias)};
+	}
+
+	std::size_t SpatialGrid::bucketOf(std::uint64_t key) const
+	{
+		// The splitmix64 finalizer, so that neighbouring cells land in
+		// unrelated buckets.
+		key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+		key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+		return static_cast<std::size_t>(key ^ (key >> 31)) & mask;
+	}
+
+	template <typename F>
+	void SpatialGrid::forEachInCell(const Cell& c, F f) const
+	{
+		const std::uint64_t key = keyOf(c);
+		const std::size_t bucket = bucketOf(key);
+		for (std::size_t s = bucketStart[bucket]; s < bucketStart[bucket + 1]; ++s)
+		{
+			if (keys[s] == key) f(s);
+		}
+	}
+
+	template <typename Consider, typename Bound>
+	void SpatialGrid::searchNearest(const Vector3& p, Consider consider, Bound bound) const
+	{
+		for (const std::uint32_t index : moved)
+		{
+			consider(index, sqrDistance(p, points[index]));
+		}
+		if (highest.x < lowest.x) return;
+
+		auto visit = [&](const std::int32_t x, const std::int32_t y, const std::int32_t z)
+		{
+			forEachInCell(Cell{x, y, z}, [&](const std::size_t s)
+			{
+				const float dx = xs[s] - p.x, dy = ys[s] - p.y, dz = zs[s] - p.z;
+				consider(indices[s], dx * dx + dy * dy + dz * dz);
+			});
+		};
+
+		// Shell R holds the cells at Chebyshev distance R from the cell of
+		// p, clipped to the occupied range. Once it has been visited, every
+		// point left is at least R cells away.
+		const Cell c = cellOf(p);
+		const std::int32_t start = std::max({0, lowest.x - c.x, c.x - highest.x, lowest.y - c.y, c.y - highest.y,
+			lowest.z - c.z, c.z - highest.z});
+		for (std::int32_t r = start; ; ++r)
+		{
+			const std::int32_t x0 = std::max(c.x - r, lowest.x), x1 = std::min(c.x + r, highest.x);
+			const std::int32_t y0 = std::max(c.y - r, lowest.y), y1 = std::min(c.y + r, highest.y);
+			const std::int32_t z0 = std::max(c.z - r, lowest.z), z1 = std::min(c.z + r, highest.z);
+
+			// The shells up to R cover the clipped box, so past this many
+			// cells a query from a void or towards an outlier visits more
+			// cells than there are points: test the rest of them instead.
+			const double cells = (double(x1) - x0 + 1) * (double(y1) - y0 + 1) * (double(z1) - z0 + 1);
+			if (cells > double(xs.size()))
+			{
+				for (std::size_t s = 0; s < xs.size(); ++s)
+				{
+					if (keys[s] == DEAD) continue;
+					const Cell q = cellOfKey(keys[s]);
+					if (std::max({std::abs(q.x - c.x), std::abs(q.y - c.y), std::abs(q.z - c.z)}) < r) continue;
+					const float dx = xs[s] - p.x, dy = ys[s] - p.y, dz = zs[s] - p.z;
+					consider(indices[s], dx * dx + dy * dy + dz * dz);
+				}
+				break;
+			}
+
+			const bool lowZ = c.z - r >= lowest.z, highZ = r > 0 && c.z + r <= highest.z;
+			const bool faceY = c.y - r >= lowest.y || c.y + r <= highest.y;
+
+			// Rows and columns inside the shell only cross it at their ends,
+			// so they are skipped when both ends are out of range.
+			for (std::int32_t x = x0; x <= x1; ++x)
+			{
+				const bool faceX = x == c.x - r || x == c.x + r;
+				if (!faceX && !faceY && !lowZ && !highZ)
+				{
+					x = std::max(x, c.x + r - 1);
+					continue;
+				}
+				for (std::int32_t y = y0; y <= y1; ++y)
+				{
+					if (faceX || y == c.y - r || y == c.y + r)
+					{
+						for (std::int32_t z = z0; z <= z1; ++z) visit(x, y, z);
+					}
+					else if (lowZ || highZ)
+					{
+						if (lowZ) visit(x, y, c.z - r);
+						if (highZ) visit(x, y, c.z + r);
+					}
+					else
+					{
+						y = std::max(y, c.y + r - 1);
+					}
+				}
+			}
+
+			const float reach = float(r) * edge;
+			if (reach * reach >= bound()) break;
+			if (c.x - r <= lowest.x && c.x + r >= highest.x && c.y - r <= lowest.y && c.y + r >= highest.y
+				&& c.z - r <= lowest.z && c.z + r >= highest.z) break;
+		}
+	}
+
+	void SpatialGrid::rebuild()
+	{
+		const std::size_t count = points.size();
+		assert(count < NONE);
+
+		std::size_t buckets = 16;
+		while (buckets < 2 * count) buckets *= 2;
+		mask = buckets - 1;
+		bucketStart.assign(buckets + 1, 0);
+		pointKeys.resize(count);
+
+		lowest = Cell{CELL_LIMIT, CELL_LIMIT, CELL_LIMIT};
+		highest = Cell{-CELL_LIMIT, -CELL_LIMIT, -CELL_LIMIT};
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const Cell c = cellOf(points[i]);
+			lowest = Cell{std::min(lowest.x, c.x), std::min(lowest.y, c.y), std::min(lowest.z, c.z)};
+			highest = Cell{std::max(highest.x, c.x), std::max(highest.y, c.y), std::max(highest.z, c.z)};
+			pointKeys[i] = keyOf(c);
+			++bucketStart[bucketOf(pointKeys[i]) + 1];
+		}
+		if (count == 0)
+		{
+			lowest = Cell{0, 0, 0};
+			highest = Cell{-1, -1, -1};
+		}
+
+		// Counting sort: bucketStart[b] becomes the first slot of bucket b,
+		// advances while the bucket is filled, and is then shifted back.
+		for (std::size_t b = 0; b < buckets; ++b) bucketStart[b + 1] += bucketStart[b];
+
+		xs.resize(count);
+		ys.resize(count);
+		zs.resize(count);
+		keys.resize(count);
+		indices.resize(count);
+		slots.resize(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const std::uint32_t s = bucketStart[bucketOf(pointKeys[i])]++;
+			xs[s] = points[i].x;
+			ys[s] = points[i].y;
+			zs[s] = points[i].z;
+			keys[s] = pointKeys[i];
+			indices[s] = static_cast<std::uint32_t>(i);
+			slots[i] = s;
+		}
+		for (std::size_t b = buckets; b > 0; --b) bucketStart[b] = bucketStart[b - 1];
+		bucketStart[0] = 0;
+
+		moved.clear();
+	}
+}
@@ -0,0 +1,147 @@
+#include <M3D/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+namespace M3D
+{
+	ThreadPool::ThreadPool(unsigned int threads_)
+	: workers(threads_ != 0 ? threads_ : std::max(1u, std::thread::hardware_concurrency()))
+	, body(nullptr)
+	, count(0)
+	, grain(1)
+	, generation(0)
+	, pending(0)
+	, stopping(false)
+	{
+		runs.reset(new Run[workers]);
+		for (unsigned int i = 0; i < workers; ++i)
+		{
+			runs[i].front = 0;
+			runs[i].back = 0;
+		}
+
+		threads.reserve(workers - 1);
+		for (unsigned int i = 1; i < workers; ++i)
+		{
+			threads.emplace_back(&ThreadPool::loop, this, i);
+		}
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		start.notify_all();
+		for (std::thread& thread : threads) thread.join();
+	}
+
+	unsigned int ThreadPool::size() const
+	{
+		return workers;
+	}
+
+	void ThreadPool::parallelFor(std::size_t count_, std::size_t grain_,
+		const std::function<void(std::size_t, std::size_t, unsigned int)>& f)
+	{
+		assert(grain_ > 0);
+		if (count_ == 0) return;
+
+		const std::size_t chunks = (count_ + grain_ - 1) / grain_;
+		if (workers == 1 || chunks == 1)
+		{
+			for (std::size_t begin = 0; begin < count_; begin += grain_)
+			{
+				f(begin, std::min(begin + grain_, count_), 0);
+			}
+			return;
+		}
+
+		// Worker i starts with the i-th equal run of chunks, so that without
+		// stealing each works through a contiguous part of the range.
+		for (unsigned int i = 0; i < workers; ++i)
+		{
+			std::lock_guard<std::mutex> lock(runs[i].mutex);
+			runs[i].front = chunks * i / workers;
+			runs[i].back = chunks * (i + 1) / workers;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			body = &f;
+			count = count_;
+			grain = grain_;
+			pending = workers - 1;
+			++generation;
+		}
+		start.notify_all();
+
+		work(0);
+
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this] { return pending == 0; });
+		body = nullptr;
+	}
+
+	bool ThreadPool::take(unsigned int worker, std::size_t& chunk)
+	{
+		{
+			Run& own = runs[worker];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (own.front < own.back)
+			{
+				chunk = own.front++;
+				return true;
+			}
+		}
+
+		for (unsigned int i = 1; i < workers; ++i)
+		{
+			Run& other = runs[(worker + i) % workers];
+			std::lock_guard<std::mutex> lock(other.mutex);
+			if (other.front < other.back)
+			{
+				chunk = --other.back;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ThreadPool::work(unsigned int worker)
+	{
+		// Chunks are only handed out while the loop runs, so once none is
+		// left to take, none will be.
+		std::size_t chunk;
+		while (take(worker, chunk))
+		{
+			const std::size_t begin = chunk * grain;
+			(*body)(begin, std::min(begin + grain, count), worker);
+		}
+	}
+
+	void ThreadPool::loop(unsigned int worker)
+	{
+		unsigned long seen = 0;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				start.wait(lock, [&] { return stopping || generation != seen; });
+				if (stopping) return;
+				seen = generation;
+			}
+
+			work(worker);
+
+			bool last;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				last = --pending == 0;
+			}
+			if (last) done.notify_one();
+		}
+	}
+}
@@ -0,0 +1,51 @@
+#include <M3D/Matrix4.hpp>
+#include <M3D/Transform.hpp>
+
+#include <cassert>
+
+namespace M3D
+{
+	namespace
+	{
+		Vector3 reciprocal(const Vector3& v)
+		{
+			assert(v.x != 0.0f && v.y != 0.0f && v.z != 0.0f);
+			return Vector3(1.0f / v.x, 1.0f / v.y, 1.0f / v.z);
+		}
+	}
+
+	Vector3 Transform::inverseTransformPoint(const Vector3& point) const
+	{
+		return M3D::scale(reciprocal(scale), rotation.conjugate() * (point - position));
+	}
+
+	Transform Transform::inverse() const
+	{
+		const Quaternion inverseRotation = rotation.conjugate();
+		const Vector3 inverseScale = reciprocal(scale);
+		// The translation that makes inverse() * (*this) the identity:
+		// inverse().transformPoint(position) is the origin.
+		return Transform(-(inverseRotation * M3D::scale(inverseScale, position)), inverseRotation, inverseScale);
+	}
+
+	Matrix4 Transform::toMatrix4() const
+	{
+		// The columns of the rotation matrix, each times its scale factor.
+		const Quaternion& q = rotation;
+		const float xx = 2.0f * q.x * q.x, yy = 2.0f * q.y * q.y, zz = 2.0f * q.z * q.z;
+		const float xy = 2.0f * q.x * q.y, xz = 2.0f * q.x * q.z, yz = 2.0f * q.y * q.z;
+		const float wx = 2.0f * q.w * q.x, wy = 2.0f * q.w * q.y, wz = 2.0f * q.w * q.z;
+
+		return Matrix4(
+			(1.0f - yy - zz) * scale.x, (xy - wz) * scale.y, (xz + wy) * scale.z, position.x,
+			(xy + wz) * scale.x, (1.0f - xx - zz) * scale.y, (yz - wx) * scale.z, position.y,
+			(xz - wy) * scale.x, (yz + wx) * scale.y, (1.0f - xx - yy) * scale.z, position.z,
+			0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	std::ostream& operator <<(std::ostream& out, const Transform& t)
+	{
+		out << "position " << t.position << ", rotation " << t.rotation << ", scale " << t.scale;
+		return out;
+	}
+}
@@ -0,0 +1,193 @@
+#include <M3D/TransformHierarchy.hpp>
+
+#include <cassert>
+
+namespace M3D
+{
+	const std::uint32_t TransformHierarchy::NONE = ~std::uint32_t(0);
+
+	TransformHierarchy::TransformHierarchy()
+	: dirtyNodes(0)
+	{
+		// Nothing to do.
+	}
+
+	std::uint32_t TransformHierarchy::add(const Transform& local, std::uint32_t parent)
+	{
+		assert(parent == NONE || parent < parents.size());
+		assert(parents.size() < NONE);
+
+		const std::uint32_t node = static_cast<std::uint32_t>(parents.size());
+		parents.push_back(parent);
+		firstChildren.push_back(NONE);
+		nextSiblings.push_back(NONE);
+		locals.push_back(local);
+		worlds.push_back(Matrix4::IDENTITY);
+		dirty.push_back(0);
+		listed.push_back(0);
+
+		if (parent != NONE)
+		{
+			nextSiblings[node] = firstChildren[parent];
+			firstChildren[parent] = node;
+		}
+
+		markDirty(node);
+		return node;
+	}
+
+	void TransformHierarchy::reserve(std::size_t count)
+	{
+		parents.reserve(count);
+		firstChildren.reserve(count);
+		nextSiblings.reserve(count);
+		locals.reserve(count);
+		worlds.reserve(count);
+		dirty.reserve(count);
+		listed.reserve(count);
+	}
+
+	void TransformHierarchy::clear()
+	{
+		parents.clear();
+		firstChildren.clear();
+		nextSiblings.clear();
+		locals.clear();
+		worlds.clear();
+		dirty.clear();
+		listed.clear();
+		pending.clear();
+		dirtyNodes = 0;
+	}
+
+	std::size_t TransformHierarchy::size() const
+	{
+		return parents.size();
+	}
+
+	std::uint32_t TransformHierarchy::parent(std::uint32_t node) const
+	{
+		assert(node < parents.size());
+		return parents[node];
+	}
+
+	const Transform& TransformHierarchy::local(std::uint32_t node) const
+	{
+		assert(node < locals.size());
+		return locals[node];
+	}
+
+	void TransformHierarchy::setLocal(std::uint32_t node, const Transform& local)
+	{
+		assert(node < locals.size());
+		locals[node] = local;
+		markDirty(node);
+	}
+
+	const Matrix4& TransformHierarchy::world(std::uint32_t node)
+	{
+		assert(node < worlds.size());
+		if (dirty[node])
+		{
+			recompute(node);
+		}
+		return worlds[node];
+	}
+
+	void TransformHierarchy::update()
+	{
+		if (dirtyNodes > parents.size() / 8)
+		{
+			// With this many, one pass in index order, where every parent
+			// comes before its children, beats visiting them in the scattered
+			// order they were marked.
+			for (std::size_t n = 0; n < parents.size(); ++n)
+			{
+				if (dirty[n])
+				{
+					const std::uint32_t p = parents[n];
+					worlds[n] = p == NONE ? locals[n].toMatrix4() : worlds[p] * locals[n].toMatrix4();
+					dirty[n] = 0;
+				}
+			}
+			for (const std::uint32_t n : pending)
+			{
+				listed[n] = 0;
+			}
+			dirtyNodes = 0;
+		}
+		else
+		{
+			// The pending list is not in parent-first order, since marking a
+			// child before its parent lists it first, so each node is brought
+			// up to date through its ancestors like in world().
+			for (const std::uint32_t n : pending)
+			{
+				if (dirty[n])
+				{
+					recompute(n);
+				}
+				listed[n] = 0;
+			}
+			assert(dirtyNodes == 0);
+		}
+		pending.clear();
+	}
+
+	std::size_t TransformHierarchy::dirtyCount() const
+	{
+		return dirtyNodes;
+	}
+
+	void TransformHierarchy::recompute(std::uint32_t node)
+	{
+		// Climb to the highest dirty ancestor, then come back down. The
+		// ancestors above it are clean, since marking a node marks its whole
+		// subtree.
+		stack.clear();
+		for (std::uint32_t n = node; n != NONE && dirty[n]; n = parents[n])
+		{
+			stack.push_back(n);
+		}
+		while (!stack.empty())
+		{
+			const std::uint32_t n = stack.back();
+			stack.pop_back();
+			const std::uint32_t p = parents[n];
+			worlds[n] = p == NONE ? locals[n].toMatrix4() : worlds[p] * locals[n].toMatrix4();
+			dirty[n] = 0;
+			--dirtyNodes;
+		}
+	}
+
+	void TransformHierarchy::markDirty(std::uint32_t node)
+	{
+		if (dirty[node])
+		{
+			return;
+		}
+
+		stack.clear();
+		stack.push_back(node);
+		while (!stack.empty())
+		{
+			const std::uint32_t n = stack.back();
+			stack.pop_back();
+			dirty[n] = 1;
+			++dirtyNodes;
+			if (!listed[n])
+			{
+				listed[n] = 1;
+				pending.push_back(n);
+			}
+
+			for (std::uint32_t child = firstChildren[n]; child != NONE; child = nextSiblings[child])
+			{
+				if (!dirty[child])
+				{
+					stack.push_back(child);
+				}
+			}
+		}
+	}
+}
@@ -1,21 +1,59 @@
+#pragma once
+
 #include "Vector3.hpp"
 #include "Quaternion.hpp"
+#include "M3D/Precision.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Wraps angle in degrees into [0, 360] in constant time, whatever its
+// size. Positive multiples of 360 give 360 and the others in (0, 360]
+// stay as they are, as with the loops this replaced. Infinities and NaN
+// give NaN.
+inline float NormalizeAngle (float angle){
+    const float turns = angle > 0 ? -std::floor(-angle / 360.0f) - 1.0f : std::floor(angle / 360.0f);
+    return std::min(std::max(angle - 360.0f * turns, 0.0f), 360.0f);
+}
+
+// The same in radians, into [0, 2 pi].
+inline float NormalizeAngleRad (float angle){
+    const float turn = 6.28318531f;
+    const float turns = angle > 0 ? -std::floor(-angle / turn) - 1.0f : std::floor(angle / turn);
+    return std::min(std::max(angle - turn * turns, 0.0f), turn);
+}
+
+// Shortest signed rotation in degrees from current to target, in
+// (-180, 180], as Mathf.DeltaAngle.
+inline float DeltaAngle (float current, float target){
+    const float delta = target - current;
+    return delta - 360.0f * std::ceil((delta - 180.0f) / 360.0f);
+}
 
-float NormalizeAngle (float angle){
-    while (angle>360)
-        angle -= 360;
-    while (angle<0)
-        angle += 360;
-    return angle;
+// The same in radians, in (-pi, pi].
+inline float DeltaAngleRad (float current, float target){
+    const float delta = target - current;
+    return delta - 6.28318531f * std::ceil((delta - 3.14159265f) / 6.28318531f);
 }
 
-Vector3 NormalizeAngles (Vector3 angles){
+inline Vector3 NormalizeAngles (Vector3 angles){
     angles.X = NormalizeAngle (angles.X);
     angles.Y = NormalizeAngle (angles.Y);
     angles.Z = NormalizeAngle (angles.Z);
     return angles;
 }
 
+// Euler angles in degrees of q1. Precision::Fast swaps atan2f/asinf for the
+// approximations in M3D/Precision.hpp (about 7e-4 degrees worst case).
+template <M3D::Precision P = M3D::Precision::Exact>
 Vector3 ToEulerRad(Quaternion q1){
     float Rad2Deg = 360.0 / (M_PI * 2.0);
 
@@ -28,28 +66,249 @@ Vector3 ToEulerRad(Quaternion q1){
     Vector3 v;
 
     if (test>0.4995*unit) {
-        v.Y = 2.0 * atan2f (q1.Y, q1.X);
+        v.Y = 2.0 * M3D::Math<P>::atan2 (q1.Y, q1.X);
         v.X = M_PI / 2.0;
         v.Z = 0;
         return NormalizeAngles(v * Rad2Deg);
     }
     if (test<-0.4995*unit) {
-        v.Y = -2.0 * atan2f (q1.Y, q1.X);
+        v.Y = -2.0 * M3D::Math<P>::atan2 (q1.Y, q1.X);
         v.X = -M_PI / 2.0;
         v.Z = 0;
         return NormalizeAngles (v * Rad2Deg);
     }
     Quaternion q(q1.W, q1.Z, q1.X, q1.Y);
-    v.Y = atan2f (2.0 * q.X * q.W + 2.0 * q.Y * q.Z, 1 - 2.0 * (q.Z * q.Z + q.W * q.W)); // yaw
-    v.X = asinf (2.0 * (q.X * q.Z - q.W * q.Y)); // pitch
-    v.Z = atan2f (2.0 * q.X * q.Y + 2.0 * q.Z * q.W, 1 - 2.0 * (q.Y * q.Y + q.Z * q.Z)); // roll
+    v.Y = M3D::Math<P>::atan2 (2.0 * q.X * q.W + 2.0 * q.Y * q.Z, 1 - 2.0 * (q.Z * q.Z + q.W * q.W)); // yaw
+    v.X = M3D::Math<P>::asin (2.0 * (q.X * q.Z - q.W * q.Y)); // pitch
+    v.Z = M3D::Math<P>::atan2 (2.0 * q.X * q.Y + 2.0 * q.Z * q.W, 1 - 2.0 * (q.Y * q.Y + q.Z * q.Z)); // roll
     return NormalizeAngles (v * Rad2Deg);
 }
 
+// NormalizeAngle on four lanes.
+inline M3D::simd::float4 monoNormalizeAngles4(M3D::simd::float4 angles){
+    using namespace M3D::simd;
+    const float4 zero = splat(0.0f);
+    const float4 full = splat(360.0f);
+    const float4 scaled = div(angles, full);
+    const float4 turns = select(greaterThan(angles, zero),
+        sub(sub(zero, floor(sub(zero, scaled))), splat(1.0f)), floor(scaled));
+    return min(max(sub(angles, mul(full, turns)), zero), full);
+}
+
+// NormalizeAngle over count angles in place, four at a time. Angles past
+// about 7e11 degrees in magnitude, where the turn count may no longer fit
+// the vector floor, and infinities and NaN give unspecified values.
+inline void NormalizeAngles (float *angles, size_t count){
+    size_t i = 0;
+    for (; i + M3D::simd::WIDTH <= count; i += M3D::simd::WIDTH)
+        M3D::simd::store(angles + i, monoNormalizeAngles4(M3D::simd::load(angles + i)));
+    for (; i < count; ++i)
+        angles[i] = NormalizeAngle(angles[i]);
+}
+
+inline void NormalizeAngles (Vector3 *angles, size_t count){
+    static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be 3 packed floats");
+    NormalizeAngles(&angles[0].X, 3 * count);
+}
+
+// ToEulerRad over count rotations, four at a time. Both pole cases and
+// the general case are computed for every lane and picked with masks, so
+// the loop has no data-dependent branches. The trigonometry is that of
+// Precision::Fast, within about 1.5e-3 degrees of the exact ToEulerRad,
+// and the sine of the pitch is clamped to [-1, 1], so quaternions that are
+// not quite unit length give a pitch of +-90 rather than NaN.
+inline void ToEulerRad(const Quaternion *rotations, Vector3 *angles, size_t count){
+    static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion must be 4 packed floats");
+    static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be 3 packed floats");
+    using namespace M3D::simd;
+
+    const float4 zero = splat(0.0f);
+    const float4 one = splat(1.0f);
+    const float4 two = splat(2.0f);
+    const float4 pole = splat(0.4995f);
+    const float4 rad2Deg = splat(57.2957795f);
+    const float4 halfPi = splat(1.57079633f);
+
+    size_t i = 0;
+    for (; i < count; i += WIDTH) {
+        // The tail is padded with identity rotations.
+        const size_t n = count - i < WIDTH ? count - i : WIDTH;
+        float padded[4 * WIDTH] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1};
+        const float *source = &rotations[i].X;
+        if (n < WIDTH) {
+            std::memcpy(padded, source, n * sizeof(Quaternion));
+            source = padded;
+        }
+
+        float4 x = load(source);
+        float4 y = load(source + 4);
+        float4 z = load(source + 8);
+        float4 w = load(source + 12);
+        transpose(x, y, z, w);
+
+        const float4 unit = madd(w, w, madd(z, z, madd(y, y, mul(x, x))));
+        const float4 test = sub(mul(x, w), mul(y, z));
+        const mask4 north = greaterThan(test, mul(pole, unit));
+        const mask4 south = greaterThan(mul(sub(zero, pole), unit), test);
+
+        const float4 poleYaw = mul(two, atan2(y, x));
+        const float4 yaw = atan2(mul(two, madd(w, y, mul(z, x))), sub(one, mul(two, madd(x, x, mul(y, y)))));
+        const float4 sinPitch = mul(two, sub(mul(w, x), mul(y, z)));
+        const float4 pitch = asin(min(max(sinPitch, splat(-1.0f)), one));
+        const float4 roll = atan2(mul(two, madd(w, z, mul(x, y))), sub(one, mul(two, madd(z, z, mul(x, x)))));
+
+        const float4 ex = select(north, halfPi, select(south, sub(zero, halfPi), pitch));
+        const float4 ey = select(north, poleYaw, select(south, sub(zero, poleYaw), yaw));
+        const float4 ez = select(north, zero, select(south, zero, roll));
+
+        float out[3 * WIDTH];
+        storeInterleaved3(n < WIDTH ? out : &angles[i].X,
+            monoNormalizeAngles4(mul(ex, rad2Deg)),
+            monoNormalizeAngles4(mul(ey, rad2Deg)),
+            monoNormalizeAngles4(mul(ez, rad2Deg)));
+        if (n < WIDTH)
+            std::memcpy(&angles[i].X, out, n * sizeof(Vector3));
+    }
+}
+
 Quaternion GetRotationToLocation(Vector3 targetLocation, float y_bias, Vector3 myLoc){
     return Quaternion::LookRotation((targetLocation + Vector3(0, y_bias, 0)) - myLoc, Vector3(0, 1, 0));
 }
 
+#if defined(__GNUC__) || defined(__clang__)
+#define MONO_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define MONO_PREFETCH(address) ((void)(address))
+#endif
+
+// Non-owning view of count contiguous elements, usable with range-for. The
+// elements stay owned by the il2cpp array they come from.
+template <typename E>
+struct monoSpan {
+    E *first;
+    size_t count;
+
+    monoSpan() : first(nullptr), count(0) {}
+    monoSpan(E *first_, size_t count_) : first(first_), count(count_) {}
+
+    E *begin() const { return first; }
+    E *end() const { return first + count; }
+    E *data() const { return first; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    E &operator[](size_t index) const {
+        assert(index < count);
+        return first[index];
+    }
+
+    // Elements [offset, offset + n), clamped to the span.
+    monoSpan subspan(size_t offset, size_t n = SIZE_MAX) const {
+        if (offset > count)
+            offset = count;
+        if (n > count - offset)
+            n = count - offset;
+        return monoSpan(first + offset, n);
+    }
+};
+
+// Calls f(element) for each object pointer in span, prefetching the object
+// `distance` elements ahead so that its fields are in cache when f reads
+// them. Null entries are passed to f as they are.
+template <typename E, typename F>
+void forEachPrefetched(monoSpan<E *> span, F f, size_t distance = 8){
+    const size_t count = span.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (i + distance < count)
+            MONO_PREFETCH(span.first[i + distance]);
+        f(span.first[i]);
+    }
+}
+
+// A field of Field type at offset bytes into an il2cpp object. Field is a
+// plain struct of floats (float, Vector3, Quaternion, ...) and is gathered
+// as sizeof(Field) / sizeof(float) lanes, in its memory order.
+template <typename Field>
+struct monoField {
+    static_assert(std::is_trivially_copyable<Field>::value && sizeof(Field) % sizeof(float) == 0,
+                  "gathered fields are made of floats");
+    static const size_t lanes = sizeof(Field) / sizeof(float);
+
+    size_t offset;
+
+    explicit monoField(size_t offset_) : offset(offset_) {}
+};
+
+// Default of monoGather: every non-null object is kept.
+struct monoAcceptAll {
+    template <typename E, typename Field>
+    bool operator()(const E *, const Field &) const { return true; }
+};
+
+// Prefetch distance of monoGather, in elements. Large out-of-order cores
+// overlap much of the misses on their own, so the distance matters most on
+// in-order and little cores; the "Unity monoGather distance" benchmarks
+// sweep it for a given device.
+const size_t MONO_GATHER_DISTANCE = 16;
+
+// Reads field from each object of objects into lanes[0 .. Field lanes),
+// one float array per lane, packed: null and misaligned object pointers
+// and objects for which accept(object, value) is false are skipped, and
+// indices (if given) receives the position in objects of each gathered
+// element. Each array must hold objects.size() floats. Returns the number
+// of elements gathered.
+//
+// Every element is a load dependent on the pointer before it, so the
+// field of the object distance elements ahead is prefetched while the
+// current one is read:
+//
+//     float *xyz[3] = {x, y, z};
+//     size_t n = monoGather(list->span(), monoField<Vector3>(positionOffset), xyz, index);
+template <typename E, typename Field, typename Accept = monoAcceptAll>
+size_t monoGather(monoSpan<E *> objects, monoField<Field> field, float *const *lanes, uint32_t *indices = nullptr,
+                  size_t distance = MONO_GATHER_DISTANCE, Accept accept = Accept()){
+    const size_t count = objects.size();
+    const size_t lineMask = ~(size_t)63;
+    auto usable = [](const E *object) {
+        return object && ((uintptr_t)object & (alignof(void *) - 1)) == 0;
+    };
+    auto prefetch = [&](const E *object) {
+        if (!usable(object))
+            return;
+        const char *first = (const char *)object + field.offset;
+        const char *last = first + sizeof(Field) - 1;
+        MONO_PREFETCH(first);
+        if (((uintptr_t)first & lineMask) != ((uintptr_t)last & lineMask))
+            MONO_PREFETCH(last);
+    };
+
+    for (size_t i = 0; i < distance && i < count; ++i)
+        prefetch(objects.first[i]);
+
+    size_t gathered = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (i + distance < count)
+            prefetch(objects.first[i + distance]);
+
+        E *object = objects.first[i];
+        if (!usable(object))
+            continue;
+        Field value;
+        std::memcpy(&value, (const char *)object + field.offset, sizeof(Field));
+        if (!accept(object, value))
+            continue;
+
+        float values[monoField<Field>::lanes];
+        std::memcpy(values, &value, sizeof(Field));
+        for (size_t lane = 0; lane < monoField<Field>::lanes; ++lane)
+            lanes[lane][gathered] = values[lane];
+        if (indices)
+            indices[gathered] = (uint32_t)i;
+        ++gathered;
+    }
+    return gathered;
+}
+
 template <typename T>
 struct monoArray
 {
@@ -66,8 +325,27 @@ struct monoArray
     {
         return (T)vector;
     }
+
+    // T is the pointer type returned by getPointer(), so the elements are
+    // of the type it points to.
+    typedef typename std::remove_pointer<T>::type element_type;
+
+    size_t length() const
+    {
+        return (size_t)(uintptr_t)max_length;
+    }
+    monoSpan<element_type> span()
+    {
+        return monoSpan<element_type>((element_type *)vector, length());
+    }
 };
 
+// Null-safe view of an il2cpp array: a null array gives an empty span.
+template <typename T>
+monoSpan<typename monoArray<T>::element_type> makeSpan(monoArray<T> *array){
+    return array ? array->span() : monoSpan<typename monoArray<T>::element_type>();
+}
+
 template <typename T>
 struct monoList {
     void *unk0;
@@ -87,6 +365,144 @@ struct monoList {
     int getVersion(){
         return version;
     }
+
+    // The size used elements of items, clamped to its capacity.
+    monoSpan<typename monoArray<T>::element_type> span(){
+        monoSpan<typename monoArray<T>::element_type> all = makeSpan(items);
+        return all.subspan(0, size > 0 ? (size_t)size : 0);
+    }
+
+    typedef typename monoArray<T>::element_type element_type;
+
+    // Copies the used elements into out, which holds capacity elements,
+    // without stopping the thread that owns the list. Seqlock style: read
+    // version, items and size, copy with one memcpy, then read version
+    // again and retry if it moved. Returns false, with count set to 0, if
+    // every attempt raced a mutation or the list holds more than capacity
+    // elements (count is then the size that was needed).
+    //
+    // The managed List bumps version after it has modified the items, so
+    // a mutation still in progress when version is read the second time
+    // (for example, the owning thread was descheduled half way through a
+    // RemoveAt shift) can go unnoticed. Reading the same version, items
+    // and size twice means no mutation completed during the copy.
+    bool snapshot(element_type *out, size_t capacity, size_t &count, int maxAttempts = 8){
+        static_assert(std::is_trivially_copyable<element_type>::value, "snapshot copies elements with memcpy");
+        const volatile monoList *self = this;
+        for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+            const int before = self->version;
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            monoArray<T> *array = self->items;
+            const int used = self->size;
+            count = 0;
+            if (!array || used < 0 || (size_t)used > array->length())
+                continue;
+            if ((size_t)used > capacity) {
+                count = (size_t)used;
+                return false;
+            }
+            std::memcpy(out, array->span().data(), (size_t)used * sizeof(element_type));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (self->version == before && self->items == array && self->size == used) {
+                count = (size_t)used;
+                return true;
+            }
+        }
+        count = 0;
+        return false;
+    }
+
+    // As above into a reusable buffer, grown as needed and resized to the
+    // number of elements copied.
+    bool snapshot(std::vector<element_type> &out, int maxAttempts = 8){
+        for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+            const int used = ((const volatile monoList *)this)->size;
+            out.resize(used > 0 ? (size_t)used : 0);
+            size_t count;
+            if (snapshot(out.data(), out.size(), count, 1)) {
+                out.resize(count);
+                return true;
+            }
+        }
+        out.clear();
+        return false;
+    }
+};
+
+// Hash codes of keys as the managed EqualityComparer<TKey>.Default computes
+// them, for the key types where that can be done without the runtime. Other
+// key types need a hasher passed to monoDictionary::find.
+template <typename Key>
+struct monoHash;
+
+template <> struct monoHash<int32_t> { int operator()(int32_t key) const { return key; } };
+template <> struct monoHash<uint32_t> { int operator()(uint32_t key) const { return (int)key; } };
+template <> struct monoHash<int64_t> { int operator()(int64_t key) const { return (int)key ^ (int)(key >> 32); } };
+template <> struct monoHash<uint64_t> { int operator()(uint64_t key) const { return (int)key ^ (int)(key >> 32); } };
+template <> struct monoHash<int16_t> { int operator()(int16_t key) const { return (int)(uint16_t)key | ((int)key << 16); } };
+template <> struct monoHash<uint16_t> { int operator()(uint16_t key) const { return (int)key; } };
+template <> struct monoHash<uint8_t> { int operator()(uint8_t key) const { return (int)key; } };
+template <> struct monoHash<bool> { int operator()(bool key) const { return key ? 1 : 0; } };
+
+// Entry of Dictionary.linkSlots: the hash code of the slot's key, with
+// MONO_HASH_FLAG set while the slot is in use, and the next slot of the
+// same bucket or MONO_NO_SLOT.
+struct monoLink {
+    int hashCode;
+    int next;
+};
+
+const int MONO_HASH_FLAG = (int)0x80000000;
+const int MONO_NO_SLOT = -1;
+
+template <typename Key, typename Value>
+struct monoDictionaryEntry {
+    Key &key;
+    Value &value;
+};
+
+// Walks the used slots of a dictionary in slot order, skipping free ones.
+template <typename Key, typename Value>
+struct monoDictionaryIterator {
+    const monoLink *links;
+    Key *keys;
+    Value *values;
+    size_t index;
+    size_t last;
+
+    monoDictionaryIterator(const monoLink *links_, Key *keys_, Value *values_, size_t index_, size_t last_)
+        : links(links_), keys(keys_), values(values_), index(index_), last(last_) {
+        skipFree();
+    }
+
+    void skipFree() {
+        while (index < last && (links[index].hashCode & MONO_HASH_FLAG) == 0)
+            ++index;
+    }
+
+    monoDictionaryEntry<Key, Value> operator*() const {
+        return monoDictionaryEntry<Key, Value>{keys[index], values[index]};
+    }
+
+    monoDictionaryIterator &operator++() {
+        ++index;
+        skipFree();
+        return *this;
+    }
+
+    bool operator==(const monoDictionaryIterator &other) const { return index == other.index; }
+    bool operator!=(const monoDictionaryIterator &other) const { return index != other.index; }
+};
+
+template <typename Iterator>
+struct monoRange {
+    Iterator first;
+    Iterator last;
+
+    Iterator begin() const { return first; }
+    Iterator end() const { return last; }
 };
 
 template <typename K, typename V>
@@ -120,6 +536,286 @@ struct monoDictionary {
     int getSize(){
         return size;
     }
+
+    // As with monoArray, K and V are the pointer types returned by
+    // getKeys() and getValues().
+    typedef typename monoArray<K>::element_type key_type;
+    typedef typename monoArray<V>::element_type mapped_type;
+    typedef monoDictionaryIterator<key_type, mapped_type> iterator;
+
+    // Slots [0, touchedSlots) that all of linkSlots, keys and values cover.
+    size_t slotCount(){
+        if (!linkSlots || !keys || !values || touchedSlots <= 0)
+            return 0;
+        size_t count = (size_t)touchedSlots;
+        count = std::min(count, linkSlots->length());
+        count = std::min(count, keys->length());
+        return std::min(count, values->length());
+    }
+
+    // Finds key the way the managed Dictionary does: the bucket
+    // table[(hash & 0x7fffffff) % table.Length] holds the first slot plus
+    // one, and linkSlots[slot].next chains the slots with the same bucket.
+    // Returns a pointer into values, or nullptr when key is absent. The
+    // walk is bounded by the slot count, so a dictionary modified while it
+    // is read cannot make it loop forever.
+    template <typename Hash = monoHash<key_type>>
+    mapped_type *find(const key_type &key, Hash hash = Hash()){
+        const size_t slots = slotCount();
+        if (!table || slots == 0)
+            return nullptr;
+
+        const size_t buckets = table->length();
+        if (buckets == 0)
+            return nullptr;
+
+        // table is declared as an array of pointers, but holds Int32s.
+        const int *bucketHeads = (const int *)table->vector;
+        const monoLink *links = (const monoLink *)linkSlots->vector;
+        const key_type *keySlots = keys->span().data();
+
+        const int hashCode = hash(key) | MONO_HASH_FLAG;
+        int slot = bucketHeads[(size_t)(hashCode & 0x7fffffff) % buckets] - 1;
+        for (size_t steps = 0; slot != MONO_NO_SLOT && steps < slots; ++steps) {
+            if (slot < 0 || (size_t)slot >= slots)
+                return nullptr;
+            if (links[slot].hashCode == hashCode && keySlots[slot] == key)
+                return &values->span()[(size_t)slot];
+            slot = links[slot].next;
+        }
+        return nullptr;
+    }
+
+    template <typename Hash = monoHash<key_type>>
+    bool tryGetValue(const key_type &key, mapped_type &value, Hash hash = Hash()){
+        mapped_type *found = find(key, hash);
+        if (!found)
+            return false;
+        value = *found;
+        return true;
+    }
+
+    template <typename Hash = monoHash<key_type>>
+    bool containsKey(const key_type &key, Hash hash = Hash()){
+        return find(key, hash) != nullptr;
+    }
+
+    // Single pass over the (key, value) pairs in slot order:
+    //     for (auto entry : dictionary->entries()) use(entry.key, entry.value);
+    monoRange<iterator> entries(){
+        const size_t slots = slotCount();
+        if (slots == 0)
+            return monoRange<iterator>{iterator(nullptr, nullptr, nullptr, 0, 0), iterator(nullptr, nullptr, nullptr, 0, 0)};
+
+        const monoLink *links = (const monoLink *)linkSlots->vector;
+        key_type *keySlots = keys->span().data();
+        mapped_type *valueSlots = values->span().data();
+        return monoRange<iterator>{iterator(links, keySlots, valueSlots, 0, slots),
+                                   iterator(links, keySlots, valueSlots, slots, slots)};
+    }
+};
+
+// Byte-wise order and FNV-1a hash of trivially copyable values, used by the
+// trackers below to compare container contents of any element type.
+template <typename E>
+struct monoBytesLess {
+    bool operator()(const E &a, const E &b) const { return std::memcmp(&a, &b, sizeof(E)) < 0; }
 };
 
+inline uint64_t monoHashBytes(const void *data, size_t length, uint64_t hash = 14695981039346656037ull){
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < length; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+
+// Multiset difference of two sorted sequences: the elements of a missing
+// from b go to onlyA and those of b missing from a to onlyB.
+template <typename E, typename Less>
+void monoSortedDiff(const std::vector<E> &a, const std::vector<E> &b, Less less,
+                    std::vector<E> &onlyA, std::vector<E> &onlyB){
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (less(a[i], b[j]))
+            onlyA.push_back(a[i++]);
+        else if (less(b[j], a[i]))
+            onlyB.push_back(b[j++]);
+        else
+            ++i, ++j;
+    }
+    onlyA.insert(onlyA.end(), a.begin() + i, a.end());
+    onlyB.insert(onlyB.end(), b.begin() + j, b.end());
+}
 
+// Follows one monoList across frames. update() first compares the
+// version, size and items array with those seen by the previous call and
+// returns false without reading any element when they match. Otherwise
+// it snapshots the list and compares a hash of the contents, so that a
+// change undone within the frame (an Add then a Remove) is still skipped,
+// and only then fills added and removed with the elements gained and lost.
+template <typename T>
+struct monoListTracker {
+    typedef typename monoArray<T>::element_type element_type;
+
+    std::vector<element_type> added;
+    std::vector<element_type> removed;
+
+    monoListTracker() : list(nullptr), items(nullptr), version(0), size(0), hash(0), seen(false) {}
+
+    // Returns true when the contents changed since the last call. A list
+    // that could not be snapshot consistently keeps its previous state and
+    // is retried on the next call.
+    bool update(monoList<T> *target){
+        added.clear();
+        removed.clear();
+
+        if (target && seen && target == list && ((volatile monoList<T> *)target)->version == version
+            && target->size == size && target->items == items)
+            return false;
+
+        if (target) {
+            const int before = ((volatile monoList<T> *)target)->version;
+            if (!target->snapshot(scratch))
+                return false;
+            current.swap(scratch);
+            list = target;
+            items = target->items;
+            version = before;
+            size = (int)current.size();
+        } else {
+            list = nullptr;
+            items = nullptr;
+            version = 0;
+            size = 0;
+            current.clear();
+        }
+
+        const uint64_t currentHash = monoHashBytes(current.data(), current.size() * sizeof(element_type));
+        if (seen && currentHash == hash && current.size() == sorted.size())
+            return false;
+
+        const bool first = !seen;
+        seen = true;
+        hash = currentHash;
+        std::vector<element_type> previous;
+        previous.swap(sorted);
+        sorted = current;
+        std::sort(sorted.begin(), sorted.end(), monoBytesLess<element_type>());
+        if (first) {
+            added = sorted;
+            return !added.empty();
+        }
+        monoSortedDiff(sorted, previous, monoBytesLess<element_type>(), added, removed);
+        return !added.empty() || !removed.empty();
+    }
+
+    // The elements as of the last update(), in list order.
+    const std::vector<element_type> &elements() const { return current; }
+
+private:
+    monoList<T> *list;
+    monoArray<T> *items;
+    int version;
+    int size;
+    uint64_t hash;
+    bool seen;
+    std::vector<element_type> current;
+    std::vector<element_type> sorted;
+    // Where snapshot() writes, so that a failed one leaves current alone.
+    std::vector<element_type> scratch;
+};
+
+// Follows one monoDictionary across frames. The Mono dictionary has no
+// version field in this layout, so update() compares touchedSlots,
+// emptySlot, size and the slot arrays instead, and with hashContents also
+// a hash of the used slots, which are contiguous and cheap to read
+// compared with a diff. Without it an in-place value overwrite goes
+// unnoticed. On a change, added holds the new keys, changed the keys whose
+// value differs and removed the keys that are gone.
+template <typename K, typename V>
+struct monoDictionaryTracker {
+    typedef typename monoDictionary<K, V>::key_type key_type;
+    typedef typename monoDictionary<K, V>::mapped_type mapped_type;
+    typedef std::pair<key_type, mapped_type> entry_type;
+
+    std::vector<entry_type> added;
+    std::vector<entry_type> changed;
+    std::vector<key_type> removed;
+
+    monoDictionaryTracker() : dictionary(nullptr), keys(nullptr), values(nullptr), touchedSlots(0), emptySlot(0),
+                              size(0), hash(0), seen(false) {}
+
+    bool update(monoDictionary<K, V> *target, bool hashContents = true){
+        added.clear();
+        changed.clear();
+        removed.clear();
+
+        const bool sameHeader = target && seen && target == dictionary && target->keys == keys
+            && target->values == values && target->touchedSlots == touchedSlots
+            && target->emptySlot == emptySlot && target->size == size;
+        if (sameHeader && !hashContents)
+            return false;
+
+        uint64_t currentHash = 0;
+        if (target) {
+            const size_t slots = target->slotCount();
+            currentHash = monoHashBytes(target->linkSlots ? target->linkSlots->vector : nullptr, slots * sizeof(monoLink));
+            currentHash = monoHashBytes(target->keys ? target->keys->span().data() : nullptr, slots * sizeof(key_type), currentHash);
+            currentHash = monoHashBytes(target->values ? target->values->span().data() : nullptr, slots * sizeof(mapped_type), currentHash);
+        }
+        if (sameHeader && currentHash == hash)
+            return false;
+
+        dictionary = target;
+        keys = target ? target->keys : nullptr;
+        values = target ? target->values : nullptr;
+        touchedSlots = target ? target->touchedSlots : 0;
+        emptySlot = target ? target->emptySlot : 0;
+        size = target ? target->size : 0;
+        hash = currentHash;
+        seen = true;
+
+        std::vector<entry_type> current;
+        if (target) {
+            for (auto entry : target->entries())
+                current.push_back(entry_type(entry.key, entry.value));
+        }
+        std::sort(current.begin(), current.end(), keyLess);
+
+        // Merge by key: keys only in current are added, keys only in
+        // previous removed, and keys in both with different values changed.
+        size_t i = 0, j = 0;
+        while (i < current.size() || j < previous.size()) {
+            if (j == previous.size() || (i < current.size() && keyLess(current[i], previous[j]))) {
+                added.push_back(current[i++]);
+            } else if (i == current.size() || keyLess(previous[j], current[i])) {
+                removed.push_back(previous[j++].first);
+            } else {
+                if (std::memcmp(&current[i].second, &previous[j].second, sizeof(mapped_type)) != 0)
+                    changed.push_back(current[i]);
+                ++i, ++j;
+            }
+        }
+        previous.swap(current);
+        return !added.empty() || !changed.empty() || !removed.empty();
+    }
+
+    // The (key, value) pairs as of the last update(), in byte order of the
+    // keys.
+    const std::vector<entry_type> &entries() const { return previous; }
+
+private:
+    static bool keyLess(const entry_type &a, const entry_type &b){
+        return monoBytesLess<key_type>()(a.first, b.first);
+    }
+
+    monoDictionary<K, V> *dictionary;
+    monoArray<K> *keys;
+    monoArray<V> *values;
+    int touchedSlots;
+    int emptySlot;
+    int size;
+    uint64_t hash;
+    bool seen;
+    std::vector<entry_type> previous;
+};
@@ -0,0 +1,129 @@
+#include <M3D/Simd.hpp>
+#include <M3D/UnityMatrix4.hpp>
+#include <M3D/Vector3.hpp>
+#include <M3D/Vector4.hpp>
+
+#include <cmath>
+#include <cassert>
+
+namespace M3D
+{
+	bool operator==(const UnityMatrix4& A, const UnityMatrix4& B)
+	{
+		const float epsilon = 1e-6;
+		for (std::size_t i = 0; i < 16; ++i)
+		{
+			if (std::abs(A[i] - B[i]) > epsilon) return false;
+		}
+
+		return true;
+	}
+
+	bool operator!=(const UnityMatrix4& A, const UnityMatrix4& B)
+	{
+		return !(A == B);
+	}
+
+	std::ostream& operator <<(std::ostream& out, const UnityMatrix4& A)
+	{
+		return out << A.toMatrix4();
+	}
+
+	UnityMatrix4 UnityMatrix4::inverse() const
+	{
+		float det;
+		return inverse(det);
+	}
+
+	UnityMatrix4 UnityMatrix4::inverse(float& det) const
+	{
+		// The inverse of the transpose is the transpose of the inverse, so
+		// the row-major kernel gives the column-major entries directly.
+		float inv[16];
+		det = simd::inverseMatrix4(m, inv);
+
+		// Ensure that the matrix is not singular.
+		assert(det != 0.0f);
+
+		return UnityMatrix4(inv);
+	}
+
+	UnityMatrix4 UnityMatrix4::inverseAffine() const
+	{
+		// As Matrix4::inverseAffine(), with the translation in m[12..14].
+		assert(m[3] == 0.0f && m[7] == 0.0f && m[11] == 0.0f && m[15] == 1.0f);
+
+		// Cofactors of the upper 3x3 block M.
+		const float c00 = m[5] * m[10] - m[9] * m[6];
+		const float c01 = m[9] * m[2] - m[1] * m[10];
+		const float c02 = m[1] * m[6] - m[5] * m[2];
+
+		const float det = m[0] * c00 + m[4] * c01 + m[8] * c02;
+
+		// Ensure that the matrix is not singular.
+		assert(det != 0.0f);
+
+		const float invDet = 1.0f / det;
+
+		const float i00 = c00 * invDet;
+		const float i01 = (m[8] * m[6] - m[4] * m[10]) * invDet;
+		const float i02 = (m[4] * m[9] - m[8] * m[5]) * invDet;
+		const float i10 = c01 * invDet;
+		const float i11 = (m[0] * m[10] - m[8] * m[2]) * invDet;
+		const float i12 = (m[8] * m[1] - m[0] * m[9]) * invDet;
+		const float i20 = c02 * invDet;
+		const float i21 = (m[4] * m[2] - m[0] * m[6]) * invDet;
+		const float i22 = (m[0] * m[5] - m[4] * m[1]) * invDet;
+
+		return UnityMatrix4(
+			i00, i10, i20, 0.0f,
+			i01, i11, i21, 0.0f,
+			i02, i12, i22, 0.0f,
+			-(i00 * m[12] + i01 * m[13] + i02 * m[14]),
+			-(i10 * m[12] + i11 * m[13] + i12 * m[14]),
+			-(i20 * m[12] + i21 * m[13] + i22 * m[14]),
+			1.0f
+		);
+	}
+
+	UnityMatrix4 UnityMatrix4::inverseRigid() const
+	{
+		// The rotation block transposed, so its columns become the rows.
+		assert(m[3] == 0.0f && m[7] == 0.0f && m[11] == 0.0f && m[15] == 1.0f);
+
+		return UnityMatrix4(
+			m[0], m[4], m[8], 0.0f,
+			m[1], m[5], m[9], 0.0f,
+			m[2], m[6], m[10], 0.0f,
+			-(m[0] * m[12] + m[1] * m[13] + m[2] * m[14]),
+			-(m[4] * m[12] + m[5] * m[13] + m[6] * m[14]),
+			-(m[8] * m[12] + m[9] * m[13] + m[10] * m[14]),
+			1.0f
+		);
+	}
+
+	Vector3 UnityMatrix4::multiplyPoint(const Vector3& point) const
+	{
+		const float w = m[3] * point.x + m[7] * point.y + m[11] * point.z + m[15];
+		return multiplyPoint3x4(point) / w;
+	}
+
+	void UnityMatrix4::frustumPlanes(Vector4 planes[6]) const
+	{
+		// As Matrix4::frustumPlanes(), reading the rows with a stride of 4.
+		for (std::size_t i = 0; i < 6; ++i)
+		{
+			const std::size_t row = i / 2;
+			const float sign = i % 2 == 0 ? 1.0f : -1.0f;
+			const Vector4 plane(
+				m[3] + sign * m[row + 0],
+				m[7] + sign * m[row + 4],
+				m[11] + sign * m[row + 8],
+				m[15] + sign * m[row + 12]
+			);
+			const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+			assert(length != 0.0f);
+			planes[i] = plane / length;
+		}
+	}
+}
@@ -0,0 +1,399 @@
+#pragma once
+
+#include "Unity.h"
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <climits>
+#include <cerrno>
+#include <unistd.h>
+#include <unordered_map>
+
+// Reads il2cpp containers out of another process (Linux and Android 6+),
+// for tools that run outside the game. The container pointers are remote
+// addresses: their headers are copied into local monoArray, monoList and
+// monoDictionary values whose pointer fields are then only used as
+// addresses, never dereferenced.
+//
+// Reads are queued with request() and issued by flush() as vectored
+// process_vm_readv calls, up to IOV_MAX ranges per syscall. Requests that
+// span at most two pages go through a small cache of whole pages, so that
+// the list header, the array header and the first elements, which usually
+// share a page, cost one range; larger requests are read straight into
+// their destination. Nothing is cached across invalidate(), which should
+// be called whenever the target may have written, typically once a frame:
+//
+//     monoRemoteReader reader(pid);
+//     std::vector<Entity *> entities;
+//     reader.invalidate();
+//     if (reader.readList(remoteList, entities)) {
+//         std::vector<Vector3> positions(entities.size());
+//         std::vector<bool> valid;
+//         reader.gather(entities.data(), entities.size(), positionOffset, positions.data(), valid);
+//     }
+//
+// The target must be readable under ptrace rules: the reader is its
+// parent, runs as root or the target allowed it with PR_SET_PTRACER.
+class monoRemoteReader {
+public:
+    // Counters since construction, for tuning cachePages.
+    size_t syscalls;
+    size_t pageHits;
+    size_t pageMisses;
+
+    // Upper bound on the element count of a container read by the typed
+    // helpers, so that a stale pointer to garbage fails instead of
+    // allocating gigabytes.
+    size_t maxElements;
+
+    explicit monoRemoteReader(pid_t pid, size_t cachePages = 64)
+        : syscalls(0), pageHits(0), pageMisses(0), maxElements(1 << 20), target(pid),
+          pageSize((size_t)sysconf(_SC_PAGESIZE)), nextVictim(0), stamp(0) {
+        assert(cachePages >= DIRECT_PAGES);
+        pages.resize(cachePages * pageSize);
+        slots.resize(cachePages);
+        for (Slot &slot : slots)
+            slot = Slot{NO_PAGE, 0};
+    }
+
+    pid_t pid() const { return target; }
+
+    // Drops every cached page.
+    void invalidate(){
+        lookup.clear();
+        for (Slot &slot : slots)
+            slot.page = NO_PAGE;
+    }
+
+    // Queues a read of size bytes at address into out, which must stay
+    // valid until flush(). Returns a ticket for succeeded().
+    size_t request(uintptr_t address, void *out, size_t size){
+        requests.push_back(Request{address, (unsigned char *)out, size, false, false});
+        return requests.size() - 1;
+    }
+
+    template <typename T>
+    size_t request(uintptr_t address, T &out){
+        static_assert(std::is_trivially_copyable<T>::value, "remote values are copied byte-wise");
+        return request(address, &out, sizeof(T));
+    }
+
+    // Issues the queued requests and forgets them, keeping only whether
+    // each succeeded. Returns the number that failed, whose destinations
+    // are left in an unspecified state.
+    size_t flush(){
+        size_t failed = 0;
+        size_t next = 0;
+        while (next < requests.size()) {
+            const size_t end = plan(next);
+            transfer();
+            for (size_t i = next; i < end; ++i) {
+                Request &r = requests[i];
+                if (r.cached)
+                    r.ok = copyFromCache(r);
+                failed += r.ok ? 0 : 1;
+            }
+            next = end;
+        }
+
+        results.resize(requests.size());
+        for (size_t i = 0; i < requests.size(); ++i)
+            results[i] = requests[i].ok;
+        requests.clear();
+        return failed;
+    }
+
+    // Whether the request with this ticket was read, until the next flush().
+    bool succeeded(size_t ticket) const {
+        return ticket < results.size() && results[ticket];
+    }
+
+    bool read(uintptr_t address, void *out, size_t size){
+        request(address, out, size);
+        return flush() == 0;
+    }
+
+    template <typename T>
+    bool read(uintptr_t address, T &out){
+        request(address, out);
+        return flush() == 0;
+    }
+
+    // Reads the elements of a remote array: the header, then the elements.
+    template <typename T>
+    bool readArray(monoArray<T> *remote, std::vector<typename monoArray<T>::element_type> &out){
+        typedef typename monoArray<T>::element_type E;
+        static_assert(std::is_trivially_copyable<E>::value, "remote values are copied byte-wise");
+        out.clear();
+        monoArray<T> header;
+        if (!remote || !read((uintptr_t)remote, &header, offsetof(monoArray<T>, vector)))
+            return false;
+        if (header.length() > maxElements)
+            return false;
+        out.resize(header.length());
+        return out.empty() || read((uintptr_t)remote + offsetof(monoArray<T>, vector), out.data(), out.size() * sizeof(E));
+    }
+
+    // Reads the size used elements of a remote list in two round trips:
+    // the list header, then the items array length and elements together.
+    template <typename T>
+    bool readList(monoList<T> *remote, std::vector<typename monoList<T>::element_type> &out){
+        typedef typename monoList<T>::element_type E;
+        static_assert(std::is_trivially_copyable<E>::value, "remote values are copied byte-wise");
+        out.clear();
+        monoList<T> list;
+        if (!remote || !read((uintptr_t)remote, list))
+            return false;
+        if (!list.items || list.size < 0 || (size_t)list.size > maxElements)
+            return false;
+
+        monoArray<T> header;
+        out.resize((size_t)list.size);
+        request((uintptr_t)list.items, &header, offsetof(monoArray<T>, vector));
+        if (!out.empty())
+            request((uintptr_t)list.items + offsetof(monoArray<T>, vector), out.data(), out.size() * sizeof(E));
+        if (flush() != 0 || out.size() > header.length()) {
+            out.clear();
+            return false;
+        }
+        return true;
+    }
+
+    // Reads the (key, value) pairs of a remote dictionary in slot order,
+    // in two round trips: the dictionary header, then the lengths and used
+    // slots of linkSlots, keys and values together.
+    template <typename K, typename V>
+    bool readDictionary(monoDictionary<K, V> *remote,
+                        std::vector<std::pair<typename monoDictionary<K, V>::key_type,
+                                              typename monoDictionary<K, V>::mapped_type>> &out){
+        typedef typename monoDictionary<K, V>::key_type Key;
+        typedef typename monoDictionary<K, V>::mapped_type Value;
+        static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<Value>::value,
+                      "remote values are copied byte-wise");
+        out.clear();
+        monoDictionary<K, V> dictionary;
+        if (!remote || !read((uintptr_t)remote, dictionary))
+            return false;
+        if (!dictionary.linkSlots || !dictionary.keys || !dictionary.values)
+            return false;
+        if (dictionary.touchedSlots < 0 || (size_t)dictionary.touchedSlots > maxElements)
+            return false;
+
+        const size_t slots = (size_t)dictionary.touchedSlots;
+        monoArray<void **> linkHeader;
+        monoArray<K> keyHeader;
+        monoArray<V> valueHeader;
+        std::vector<monoLink> links(slots);
+        std::vector<Key> keys(slots);
+        std::vector<Value> values(slots);
+        request((uintptr_t)dictionary.linkSlots, &linkHeader, offsetof(monoArray<void **>, vector));
+        request((uintptr_t)dictionary.keys, &keyHeader, offsetof(monoArray<K>, vector));
+        request((uintptr_t)dictionary.values, &valueHeader, offsetof(monoArray<V>, vector));
+        if (slots > 0) {
+            request((uintptr_t)dictionary.linkSlots + offsetof(monoArray<void **>, vector), links.data(), slots * sizeof(monoLink));
+            request((uintptr_t)dictionary.keys + offsetof(monoArray<K>, vector), keys.data(), slots * sizeof(Key));
+            request((uintptr_t)dictionary.values + offsetof(monoArray<V>, vector), values.data(), slots * sizeof(Value));
+        }
+        if (flush() != 0)
+            return false;
+        if (slots > linkHeader.length() || slots > keyHeader.length() || slots > valueHeader.length())
+            return false;
+
+        for (size_t i = 0; i < slots; ++i) {
+            if (links[i].hashCode & MONO_HASH_FLAG)
+                out.push_back(std::make_pair(keys[i], values[i]));
+        }
+        return true;
+    }
+
+    // Reads the field at offset of each remote object into out[i], in one
+    // flush. valid[i] is false for null objects, which are not read, and
+    // for objects whose memory could not be read. Returns the number of
+    // fields read.
+    template <typename Object, typename Field>
+    size_t gather(Object *const *objects, size_t count, size_t offset, Field *out, std::vector<bool> &valid){
+        static_assert(std::is_trivially_copyable<Field>::value, "remote values are copied byte-wise");
+        valid.assign(count, false);
+        std::vector<size_t> tickets(count, (size_t)-1);
+        bool requested = false;
+        for (size_t i = 0; i < count; ++i) {
+            if (objects[i]) {
+                tickets[i] = request((uintptr_t)objects[i] + offset, out[i]);
+                requested = true;
+            }
+        }
+        if (!requested)
+            return 0;
+        flush();
+
+        size_t read = 0;
+        for (size_t i = 0; i < count; ++i) {
+            valid[i] = tickets[i] != (size_t)-1 && succeeded(tickets[i]);
+            read += valid[i] ? 1 : 0;
+        }
+        return read;
+    }
+
+private:
+    // Requests spanning more pages than this bypass the cache.
+    static const size_t DIRECT_PAGES = 2;
+    static const uintptr_t NO_PAGE = ~(uintptr_t)0;
+
+    struct Request {
+        uintptr_t address;
+        unsigned char *out;
+        size_t size;
+        bool ok;
+        bool cached;
+    };
+
+    struct Slot {
+        uintptr_t page;
+        size_t stamp;
+    };
+
+    // Remote range of one iovec of the next transfer: a page filling a
+    // cache slot, or a request read straight into its destination.
+    struct Pending {
+        bool direct;
+        size_t index;
+    };
+
+    // Queues the ranges for requests [first, end) and returns end, which
+    // stops before the request that would need more pages than the cache
+    // holds. Pages used by these requests are stamped so that they are not
+    // evicted before the requests are served.
+    size_t plan(size_t first){
+        local.clear();
+        remote.clear();
+        pending.clear();
+        ++stamp;
+
+        size_t pinned = 0;
+        size_t end = first;
+        for (; end < requests.size(); ++end) {
+            Request &r = requests[end];
+            r.ok = r.size == 0;
+            r.cached = false;
+            if (r.size == 0)
+                continue;
+
+            const uintptr_t firstPage = r.address / pageSize;
+            const uintptr_t lastPage = (r.address + r.size - 1) / pageSize;
+            if (lastPage - firstPage + 1 > DIRECT_PAGES) {
+                queue(r.out, r.address, r.size, Pending{true, end});
+                r.ok = true;
+                continue;
+            }
+            if (pinned + (lastPage - firstPage + 1) > slots.size())
+                break;
+            r.cached = true;
+
+            for (uintptr_t page = firstPage; page <= lastPage; ++page) {
+                auto found = lookup.find(page);
+                if (found != lookup.end()) {
+                    ++pageHits;
+                    if (slots[found->second].stamp != stamp) {
+                        slots[found->second].stamp = stamp;
+                        ++pinned;
+                    }
+                    continue;
+                }
+                ++pageMisses;
+                const size_t slot = evict();
+                slots[slot] = Slot{page, stamp};
+                lookup[page] = slot;
+                ++pinned;
+                queue(&pages[slot * pageSize], page * pageSize, pageSize, Pending{false, slot});
+            }
+        }
+        return end;
+    }
+
+    // Round robin over the slots not used by the current requests.
+    size_t evict(){
+        while (slots[nextVictim].stamp == stamp)
+            nextVictim = (nextVictim + 1) % slots.size();
+        const size_t slot = nextVictim;
+        nextVictim = (nextVictim + 1) % slots.size();
+        if (slots[slot].page != NO_PAGE)
+            lookup.erase(slots[slot].page);
+        return slot;
+    }
+
+    void queue(void *to, uintptr_t from, size_t size, Pending owner){
+        local.push_back(iovec{to, size});
+        remote.push_back(iovec{(void *)from, size});
+        pending.push_back(owner);
+    }
+
+    // Reads the queued ranges. process_vm_readv stops at the first range
+    // it cannot read completely and reports the bytes read up to there,
+    // so the call resumes after that range.
+    void transfer(){
+#ifdef IOV_MAX
+        const size_t maxRanges = IOV_MAX;
+#else
+        const size_t maxRanges = 1024;
+#endif
+        size_t done = 0;
+        while (done < remote.size()) {
+            const size_t batch = std::min(remote.size() - done, maxRanges);
+            const ssize_t result = process_vm_readv(target, &local[done], batch, &remote[done], batch, 0);
+            ++syscalls;
+            if (result < 0 && errno != EFAULT) {
+                // The process is gone or may not be read: nothing will be.
+                for (; done < remote.size(); ++done)
+                    fail(pending[done]);
+                return;
+            }
+
+            size_t bytes = result < 0 ? 0 : (size_t)result;
+            size_t i = done;
+            while (i < done + batch && bytes >= remote[i].iov_len) {
+                bytes -= remote[i].iov_len;
+                ++i;
+            }
+            if (i < done + batch)
+                fail(pending[i++]);
+            done = i;
+        }
+    }
+
+    void fail(const Pending &owner){
+        if (owner.direct) {
+            requests[owner.index].ok = false;
+        } else {
+            lookup.erase(slots[owner.index].page);
+            slots[owner.index].page = NO_PAGE;
+        }
+    }
+
+    bool copyFromCache(const Request &r){
+        size_t copied = 0;
+        while (copied < r.size) {
+            const uintptr_t address = r.address + copied;
+            auto found = lookup.find(address / pageSize);
+            if (found == lookup.end())
+                return false;
+            const size_t inPage = address % pageSize;
+            const size_t n = std::min(r.size - copied, pageSize - inPage);
+            std::memcpy(r.out + copied, &pages[found->second * pageSize + inPage], n);
+            copied += n;
+        }
+        return true;
+    }
+
+    pid_t target;
+    size_t pageSize;
+    size_t nextVictim;
+    size_t stamp;
+    std::vector<unsigned char> pages;
+    std::vector<Slot> slots;
+    std::unordered_map<uintptr_t, size_t> lookup;
+    std::vector<Request> requests;
+    std::vector<bool> results;
+    std::vector<iovec> local;
+    std::vector<iovec> remote;
+    std::vector<Pending> pending;
+};
@@ -0,0 +1,333 @@
+#include <M3D/Simd.hpp>
+#include <M3D/Vector3SoA.hpp>
+
+#include <cmath>
+#include <cassert>
+
+namespace M3D
+{
+	Vector3SoA::Vector3SoA()
+	{
+		// Nothing to do.
+	}
+
+	Vector3SoA::Vector3SoA(std::size_t size)
+	: xs(size)
+	, ys(size)
+	, zs(size)
+	{
+		// Nothing to do.
+	}
+
+	Vector3SoA::Vector3SoA(const Vector3* v, std::size_t count)
+	{
+		assign(v, count);
+	}
+
+	Vector3 Vector3SoA::operator[](std::size_t index) const
+	{
+		assert(index < size());
+		return Vector3(xs[index], ys[index], zs[index]);
+	}
+
+	void Vector3SoA::set(std::size_t index, const Vector3& v)
+	{
+		assert(index < size());
+		xs[index] = v.x;
+		ys[index] = v.y;
+		zs[index] = v.z;
+	}
+
+	void Vector3SoA::append(const Vector3& v)
+	{
+		xs.push_back(v.x);
+		ys.push_back(v.y);
+		zs.push_back(v.z);
+	}
+
+	void Vector3SoA::assign(const Vector3* v, std::size_t count)
+	{
+		resize(count);
+
+		const float* src = &v->x;
+		std::size_t i = 0;
+		for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+		{
+			simd::float4 vx, vy, vz;
+			simd::loadInterleaved3(src + 3 * i, vx, vy, vz);
+			simd::store(&xs[i], vx);
+			simd::store(&ys[i], vy);
+			simd::store(&zs[i], vz);
+		}
+
+		for (; i < count; ++i) set(i, v[i]);
+	}
+
+	void Vector3SoA::copyTo(Vector3* out) const
+	{
+		const std::size_t count = size();
+
+		float* dst = &out->x;
+		std::size_t i = 0;
+		for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+		{
+			simd::storeInterleaved3(dst + 3 * i, simd::load(&xs[i]), simd::load(&ys[i]), simd::load(&zs[i]));
+		}
+
+		for (; i < count; ++i) out[i] = (*this)[i];
+	}
+
+	std::size_t Vector3SoA::size() const
+	{
+		return xs.size();
+	}
+
+	bool Vector3SoA::empty() const
+	{
+		return xs.empty();
+	}
+
+	void Vector3SoA::resize(std::size_t size)
+	{
+		xs.resize(size);
+		ys.resize(size);
+		zs.resize(size);
+	}
+
+	void Vector3SoA::reserve(std::size_t capacity)
+	{
+		xs.reserve(capacity);
+		ys.reserve(capacity);
+		zs.reserve(capacity);
+	}
+
+	void Vector3SoA::clear()
+	{
+		xs.clear();
+		ys.clear();
+		zs.clear();
+	}
+
+	float* Vector3SoA::x() { return xs.data(); }
+	float* Vector3SoA::y() { return ys.data(); }
+	float* Vector3SoA::z() { return zs.data(); }
+	const float* Vector3SoA::x() const { return xs.data(); }
+	const float* Vector3SoA::y() const { return ys.data(); }
+	const float* Vector3SoA::z() const { return zs.data(); }
+
+	void dot(const Vector3SoA& a, const Vector3SoA& b, float* out)
+	{
+		using namespace simd;
+		assert(a.size() == b.size());
+
+		const std::size_t count = a.size();
+		std::size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			float4 r = mul(load(a.x() + i), load(b.x() + i));
+			r = madd(load(a.y() + i), load(b.y() + i), r);
+			r = madd(load(a.z() + i), load(b.z() + i), r);
+			store(out + i, r);
+		}
+
+		for (; i < count; ++i) out[i] = a.x()[i] * b.x()[i] + a.y()[i] * b.y()[i] + a.z()[i] * b.z()[i];
+	}
+
+	void dot(const Vector3SoA& a, const Vector3& b, float* out)
+	{
+		using namespace simd;
+
+		const float4 bx = splat(b.x);
+		const float4 by = splat(b.y);
+		const float4 bz = splat(b.z);
+
+		const std::size_t count = a.size();
+		std::size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			float4 r = mul(load(a.x() + i), bx);
+			r = madd(load(a.y() + i), by, r);
+			r = madd(load(a.z() + i), bz, r);
+			store(out + i, r);
+		}
+
+		for (; i < count; ++i) out[i] = a.x()[i] * b.x + a.y()[i] * b.y + a.z()[i] * b.z;
+	}
+
+	void cross(const Vector3SoA& a, const Vector3SoA& b, Vector3SoA& out)
+	{
+		using namespace simd;
+		assert(a.size() == b.size());
+
+		const std::size_t count = a.size();
+		out.resize(count);
+
+		std::size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			const float4 ax = load(a.x() + i), ay = load(a.y() + i), az = load(a.z() + i);
+			const float4 bx = load(b.x() + i), by = load(b.y() + i), bz = load(b.z() + i);
+			store(out.x() + i, sub(mul(ay, bz), mul(az, by)));
+			store(out.y() + i, sub(mul(az, bx), mul(ax, bz)));
+			store(out.z() + i, sub(mul(ax, by), mul(ay, bx)));
+		}
+
+		for (; i < count; ++i) out.set(i, M3D::cross(a[i], b[i]));
+	}
+
+	void cross(const Vector3SoA& a, const Vector3& b, Vector3SoA& out)
+	{
+		using namespace simd;
+
+		const std::size_t count = a.size();
+		out.resize(count);
+
+		const float4 bx = splat(b.x), by = splat(b.y), bz = splat(b.z);
+
+		std::size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			const float4 ax = load(a.x() + i), ay = load(a.y() + i), az = load(a.z() + i);
+			store(out.x() + i, sub(mul(ay, bz), mul(az, by)));
+			store(out.y() + i, sub(mul(az, bx), mul(ax, bz)));
+			store(out.z() + i, sub(mul(ax, by), mul(ay, bx)));
+		}
+
+		for (; i < count; ++i) out.set(i, M3D::cross(a[i], b));
+	}
+
+	void sqrDistance(const Vector3& p, const Vector3SoA& points, float* out)
+	{
+		using namespace simd;
+
+		const float4 px = splat(p.x), py = splat(p.y), pz = splat(p.z);
+
+		const std::size_t count = points.size();
+		std::size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			const float4 dx = sub(load(points.x() + i), px);
+			const float4 dy = sub(load(points.y() + i), py);
+			const float4 dz = sub(load(points.z() + i), pz);
+			store(out + i, madd(dz, dz, madd(dy, dy, mul(dx, dx))));
+		}
+
+		for (; i < count; ++i) out[i] = M3D::sqrDistance(p, points[i]);
+	}
+
+	void sqrDistance(const Vector3SoA& a, const Vector3SoA& b, float* out)
+	{
+		using namespace simd;
+		assert(a.size() == b.size());
+
+		const std::size_t count = a.size();
+		std::size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			const float4 dx = sub(load(a.x() + i), load(b.x() + i));
+			const float4 dy = sub(load(a.y() + i), load(b.y() + i));
+			const float4 dz = sub(load(a.z() + i), load(b.z() + i));
+			store(out + i, madd(dz, dz, madd(dy, dy, mul(dx, dx))));
+		}
+
+		for (; i < count; ++i) out[i] = M3D::sqrDistance(a[i], b[i]);
+	}
+
+	void distance(const Vector3& p, const Vector3SoA& points, float* out)
+	{
+		sqrDistance(p, points, out);
+
+		const std::size_t count = points.size();
+		std::size_t i = 0;
+		for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+		{
+			simd::store(out + i, simd::sqrt(simd::load(out + i)));
+		}
+
+		for (; i < count; ++i) out[i] = std::sqrt(out[i]);
+	}
+
+	void distance(const Vector3SoA& a, const Vector3SoA& b, float* out)
+	{
+		sqrDistance(a, b, out);
+
+		const std::size_t count = a.size();
+		std::size_t i = 0;
+		for (; i + simd::WIDTH <= count; i += simd::WIDTH)
+		{
+			simd::store(out + i, simd::sqrt(simd::load(out + i)));
+		}
+
+		for (; i < count; ++i) out[i] = std::sqrt(out[i]);
+	}
+
+	void rotate(const Quaternion& q, const Vector3SoA& in, Vector3SoA& out)
+	{
+		using namespace simd;
+
+		const std::size_t count = in.size();
+		out.resize(count);
+
+		const float4 qw = splat(q.w), qx = splat(q.x), qy = splat(q.y), qz = splat(q.z);
+
+		std::size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			float4 x = load(in.x() + i), y = load(in.y() + i), z = load(in.z() + i);
+			rotateVector3(qw, qx, qy, qz, x, y, z);
+			store(out.x() + i, x);
+			store(out.y() + i, y);
+			store(out.z() + i, z);
+		}
+
+		for (; i < count; ++i) out.set(i, q * in[i]);
+	}
+
+	std::size_t normalize(const Vector3SoA& in, Vector3SoA& out, bool* valid)
+	{
+		using namespace simd;
+
+		const std::size_t count = in.size();
+		out.resize(count);
+
+		const float4 zero = splat(0.0f);
+		const float4 one = splat(1.0f);
+		std::size_t numValid = 0;
+
+		std::size_t i = 0;
+		for (; i + WIDTH <= count; i += WIDTH)
+		{
+			const float4 x = load(in.x() + i), y = load(in.y() + i), z = load(in.z() + i);
+			const float4 sqrLength = madd(z, z, madd(y, y, mul(x, x)));
+
+			// Zero-length lanes get a scale of zero instead of a division by
+			// zero, so the whole block is processed without branching.
+			const mask4 nonZero = greaterThan(sqrLength, zero);
+			const float4 invLength = select(nonZero, div(one, sqrt(sqrLength)), zero);
+
+			store(out.x() + i, mul(x, invLength));
+			store(out.y() + i, mul(y, invLength));
+			store(out.z() + i, mul(z, invLength));
+
+			const unsigned int bits = moveMask(nonZero);
+			for (unsigned int lane = 0; lane < WIDTH; ++lane)
+			{
+				const bool laneValid = (bits >> lane) & 1u;
+				if (valid) valid[i + lane] = laneValid;
+				numValid += laneValid;
+			}
+		}
+
+		for (; i < count; ++i)
+		{
+			const Vector3 v = in[i];
+			const float sqrLength = v.sqrMagnitude();
+			const bool laneValid = sqrLength > 0.0f;
+			out.set(i, laneValid ? v * (1.0f / std::sqrt(sqrLength)) : Vector3::ZERO);
+			if (valid) valid[i] = laneValid;
+			numValid += laneValid;
+		}
+
+		return numValid;
+	}
+}
@@ -0,0 +1,826 @@
+// Microbenchmarks for the M3D library and Unity.h.
+//
+// Build from this directory, for example:
+//
+//	g++ -std=c++17 -O2 -march=native -I.. Benchmark.cpp ../*.cpp -o m3d-bench
+//
+// or with the NDK clang for the target ABI. Add -DM3D_NO_SIMD to measure the
+// scalar fallback. Unity.h is only benchmarked when the Unity-style
+// Vector3.hpp and Quaternion.hpp it includes are on the include path.
+//
+// Usage: m3d-bench [--filter TEXT] [--min-time SECONDS] [--json FILE] [--baseline FILE]
+//
+// Every benchmark runs over 1, 64, 4096 and 1048576 elements and reports the
+// median time per element and elements per second over several timed runs.
+// --json saves the results; a later run given the file with --baseline
+// prints its speedup against them.
+
+#include <M3D/Batch.hpp>
+#include <M3D/Culling.hpp>
+#include <M3D/Expression.hpp>
+#include <M3D/Matrix2.hpp>
+#include <M3D/Matrix3.hpp>
+#include <M3D/Matrix4.hpp>
+#include <M3D/Projection.hpp>
+#include <M3D/QueryExecutor.hpp>
+#include <M3D/Quaternion.hpp>
+#include <M3D/SpatialGrid.hpp>
+#include <M3D/ThreadPool.hpp>
+#include <M3D/Transform.hpp>
+#include <M3D/TransformHierarchy.hpp>
+#include <M3D/UnityMatrix4.hpp>
+#include <M3D/Vector2.hpp>
+#include <M3D/Vector3.hpp>
+#include <M3D/Vector3SoA.hpp>
+#include <M3D/Vector4.hpp>
+#include <Rect.hpp>
+
+#if defined(__has_include)
+	#if __has_include("Vector3.hpp") && __has_include("Quaternion.hpp")
+		#define M3D_BENCH_UNITY 1
+		#include "../Unity.h"
+	#endif
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	const std::size_t SIZES[] = {1, 64, 4096, 1048576};
+	const std::size_t MAX_SIZE = 1048576;
+	const int REPETITIONS = 5;
+
+	// Keeps the compiler from discarding a computed value.
+	template <typename T>
+	inline void doNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static const void* volatile sink;
+		sink = &value;
+#endif
+	}
+
+	struct Benchmark
+	{
+		std::string name;
+
+		// Processes the first n elements of the input pools.
+		std::function<void(std::size_t)> body;
+	};
+
+	struct Result
+	{
+		std::string name;
+		std::size_t size;
+		double nsPerElement;
+		double elementsPerSecond;
+	};
+
+	double secondsSince(const Clock::time_point start)
+	{
+		return std::chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	// Times body(size): first doubles the number of calls per run until a run
+	// takes a tenth of minTime, then keeps the median of REPETITIONS runs of
+	// at least minTime / REPETITIONS each.
+	Result measure(const Benchmark& benchmark, const std::size_t size, const double minTime)
+	{
+		std::size_t calls = 1;
+		for (;;)
+		{
+			const Clock::time_point start = Clock::now();
+			for (std::size_t i = 0; i < calls; ++i) benchmark.body(size);
+			if (secondsSince(start) >= minTime / 10.0 || calls >= (std::size_t(1) << 30)) break;
+			calls *= 2;
+		}
+
+		std::vector<double> samples;
+		for (int r = 0; r < REPETITIONS; ++r)
+		{
+			std::size_t done = 0;
+			const Clock::time_point start = Clock::now();
+			do
+			{
+				for (std::size_t i = 0; i < calls; ++i) benchmark.body(size);
+				done += calls;
+			}
+			while (secondsSince(start) < minTime / REPETITIONS);
+			samples.push_back(secondsSince(start) * 1e9 / (double(done) * double(size)));
+		}
+
+		std::sort(samples.begin(), samples.end());
+		const double ns = samples[samples.size() / 2];
+		return Result{benchmark.name, size, ns, 1e9 / ns};
+	}
+
+	// The JSON written by saveJson() has one result per line, which is all
+	// loadBaseline() reads back.
+	bool saveJson(const char* path, const std::vector<Result>& results)
+	{
+		FILE* file = std::fopen(path, "w");
+		if (!file)
+		{
+			return false;
+		}
+
+		std::fprintf(file, "{\n\t\"results\": [\n");
+		for (std::size_t i = 0; i < results.size(); ++i)
+		{
+			const Result& r = results[i];
+			std::fprintf(file, "\t\t{\"name\": \"%s\", \"size\": %zu, \"ns_per_element\": %.6g, \"elements_per_second\": %.6g}%s\n",
+				r.name.c_str(), r.size, r.nsPerElement, r.elementsPerSecond, i + 1 < results.size() ? "," : "");
+		}
+		std::fprintf(file, "\t]\n}\n");
+		return std::fclose(file) == 0;
+	}
+
+	std::map<std::pair<std::string, std::size_t>, double> loadBaseline(const char* path)
+	{
+		std::map<std::pair<std::string, std::size_t>, double> baseline;
+		FILE* file = std::fopen(path, "r");
+		if (!file)
+		{
+			return baseline;
+		}
+
+		char line[1024];
+		while (std::fgets(line, sizeof(line), file))
+		{
+			char name[512];
+			std::size_t size;
+			double ns;
+			const char* entry = std::strstr(line, "{\"name\": \"");
+			if (entry && std::sscanf(entry, "{\"name\": \"%511[^\"]\", \"size\": %zu, \"ns_per_element\": %lf", name, &size, &ns) == 3)
+			{
+				baseline[std::make_pair(std::string(name), size)] = ns;
+			}
+		}
+		std::fclose(file);
+		return baseline;
+	}
+}
+
+namespace M3D
+{
+	namespace bench
+	{
+		// Random inputs for every benchmark, MAX_SIZE of each, plus the output
+		// arrays they write to.
+		struct Data
+		{
+			std::vector<Vector2> v2a, v2b, v2out;
+			std::vector<Vector3> v3a, v3b, v3unit, v3out, angles, anglesDegrees;
+			std::vector<Vector4> v4a, v4b, v4out;
+			std::vector<Quaternion> qa, qb, qout;
+			std::vector<Matrix2> m2a, m2out;
+			std::vector<Matrix3> m3a, m3out;
+			std::vector<Matrix4> m4a, m4rigid, m4out;
+			std::vector<UnityMatrix4> u4a, u4rigid, u4out;
+			std::vector<Transform> ta, tb, tout;
+			std::vector<float> scalars, factors, floats;
+			std::vector<std::uint8_t> flags;
+			std::vector<std::uint32_t> indices;
+
+			// Grids of the points of v3a: one rebuilt by the build benchmark,
+			// and one of all of them, with a few points per cell, to query.
+			SpatialGrid grid, fullGrid;
+
+			// A hierarchy of the transforms of ta, each node under a random
+			// earlier one and every 64th a root, and its parents.
+			TransformHierarchy hierarchy;
+			std::vector<std::uint32_t> parents;
+
+			// Pools of 1, 2, 4, 8 and one per hardware thread, and an
+			// executor on each, for the scaling of the parallel queries.
+			std::vector<std::unique_ptr<ThreadPool>> pools;
+			std::vector<std::unique_ptr<QueryExecutor>> executors;
+			QueryResults<std::uint32_t> radiusResults;
+
+			// SoA copies of v3a/v3b for each of SIZES.
+			std::vector<Vector3SoA> soaA, soaB, soaOut;
+
+			explicit Data(std::mt19937& rng)
+			: grid(0.25f)
+			, fullGrid(0.25f)
+			{
+				std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+				std::uniform_real_distribution<float> wide(-10.0f, 10.0f);
+
+				for (std::size_t i = 0; i < MAX_SIZE; ++i)
+				{
+					const Vector3 a(wide(rng), wide(rng), wide(rng));
+					const Vector3 b(wide(rng), wide(rng), wide(rng));
+					const Vector3 euler(3.0f * unit(rng), 3.0f * unit(rng), 3.0f * unit(rng));
+					const Quaternion q = Quaternion(unit(rng), unit(rng), unit(rng), unit(rng)).normalized();
+					const Quaternion r = Quaternion(unit(rng), unit(rng), unit(rng), unit(rng)).normalized();
+					const Matrix4 rigid = Matrix4::translation(b) * Matrix4(q);
+
+					v2a.push_back(Vector2(a.x, a.y));
+					v2b.push_back(Vector2(b.x, b.y));
+					v3a.push_back(a);
+					v3b.push_back(b);
+					v3unit.push_back(a.normalized());
+					angles.push_back(euler);
+					anglesDegrees.push_back(euler * 120.0f);
+					v4a.push_back(Vector4(a.x, a.y, a.z, b.x));
+					v4b.push_back(Vector4(b.x, b.y, b.z, a.x));
+					qa.push_back(q);
+					qb.push_back(r);
+					m2a.push_back(Matrix2(a.x, a.y, b.x, b.y));
+					m3a.push_back(Matrix3::euler(euler) * 2.0f);
+					m4a.push_back(rigid * Matrix4::scaling(Vector3(1.5f, 0.5f, 2.0f)));
+					m4rigid.push_back(rigid);
+					u4a.push_back(UnityMatrix4(m4a.back()));
+					u4rigid.push_back(UnityMatrix4(rigid));
+					ta.push_back(Transform(b, q, Vector3(1.5f, 0.5f, 2.0f)));
+					tb.push_back(Transform(a, r));
+					scalars.push_back(wide(rng));
+					factors.push_back(0.5f + 0.5f * unit(rng));
+				}
+
+				v2out.resize(MAX_SIZE);
+				v3out.resize(MAX_SIZE);
+				v4out.resize(MAX_SIZE);
+				qout.resize(MAX_SIZE);
+				m2out.resize(MAX_SIZE);
+				m3out.resize(MAX_SIZE);
+				m4out.resize(MAX_SIZE);
+				u4out.resize(MAX_SIZE);
+				tout.resize(MAX_SIZE);
+				floats.resize(MAX_SIZE);
+				flags.resize(MAX_SIZE);
+				indices.resize(MAX_SIZE);
+				fullGrid.build(v3a.data(), MAX_SIZE);
+
+				hierarchy.reserve(MAX_SIZE);
+				for (std::size_t i = 0; i < MAX_SIZE; ++i)
+				{
+					const std::uint32_t parent = i % 64 == 0 ? TransformHierarchy::NONE : std::uint32_t(rng() % i);
+					parents.push_back(parent);
+					hierarchy.add(ta[i], parent);
+				}
+				hierarchy.update();
+
+				std::vector<unsigned int> threads = {1, 2, 4, 8, std::max(1u, std::thread::hardware_concurrency())};
+				std::sort(threads.begin(), threads.end());
+				threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+				for (const unsigned int size : threads)
+				{
+					pools.emplace_back(new ThreadPool(size));
+					executors.emplace_back(new QueryExecutor(*pools.back()));
+				}
+
+				for (const std::size_t size : SIZES)
+				{
+					soaA.push_back(Vector3SoA(v3a.data(), size));
+					soaB.push_back(Vector3SoA(v3b.data(), size));
+					soaOut.push_back(Vector3SoA(size));
+				}
+			}
+
+			std::size_t soaIndex(const std::size_t n) const
+			{
+				std::size_t index = 0;
+				while (SIZES[index] != n) ++index;
+				return index;
+			}
+		};
+
+		// Element-wise benchmark: out[i] = f(i) for the first n elements.
+		template <typename Out, typename F>
+		Benchmark map(const std::string& name, std::vector<Out>& out, F f)
+		{
+			return Benchmark{name, [&out, f](const std::size_t n)
+			{
+				Out* o = out.data();
+				for (std::size_t i = 0; i < n; ++i) o[i] = f(i);
+				doNotOptimize(o[n - 1]);
+			}};
+		}
+
+		void add(std::vector<Benchmark>& benchmarks, Data& d)
+		{
+			const Vector2* v2a = d.v2a.data();
+			const Vector2* v2b = d.v2b.data();
+			const Vector3* v3a = d.v3a.data();
+			const Vector3* v3b = d.v3b.data();
+			const Vector3* v3unit = d.v3unit.data();
+			const Vector3* angles = d.angles.data();
+			const Vector4* v4a = d.v4a.data();
+			const Vector4* v4b = d.v4b.data();
+			const Quaternion* qa = d.qa.data();
+			const Quaternion* qb = d.qb.data();
+			const Matrix2* m2a = d.m2a.data();
+			const Matrix3* m3a = d.m3a.data();
+			const Matrix4* m4a = d.m4a.data();
+			const Matrix4* m4rigid = d.m4rigid.data();
+			const UnityMatrix4* u4a = d.u4a.data();
+			const UnityMatrix4* u4rigid = d.u4rigid.data();
+			const Transform* ta = d.ta.data();
+			const Transform* tb = d.tb.data();
+			const float* scalars = d.scalars.data();
+			const float* factors = d.factors.data();
+
+			// Vector2.
+			benchmarks.push_back(map("Vector2 +", d.v2out, [=](std::size_t i) { return v2a[i] + v2b[i]; }));
+			benchmarks.push_back(map("Vector2 dot", d.floats, [=](std::size_t i) { return dot(v2a[i], v2b[i]); }));
+			benchmarks.push_back(map("Vector2::magnitude", d.floats, [=](std::size_t i) { return v2a[i].magnitude(); }));
+			benchmarks.push_back(map("Vector2::normalized", d.v2out, [=](std::size_t i) { return v2a[i].normalized(); }));
+			benchmarks.push_back(map("Vector2 angle", d.floats, [=](std::size_t i) { return angle(v2a[i], v2b[i]); }));
+			benchmarks.push_back(map("Vector2 distance", d.floats, [=](std::size_t i) { return distance(v2a[i], v2b[i]); }));
+
+			// Vector3.
+			benchmarks.push_back(map("Vector3 +", d.v3out, [=](std::size_t i) { return v3a[i] + v3b[i]; }));
+			benchmarks.push_back(map("Vector3 * float", d.v3out, [=](std::size_t i) { return v3a[i] * scalars[i]; }));
+			benchmarks.push_back(map("Vector3 dot", d.floats, [=](std::size_t i) { return dot(v3a[i], v3b[i]); }));
+			benchmarks.push_back(map("Vector3 cross", d.v3out, [=](std::size_t i) { return cross(v3a[i], v3b[i]); }));
+			benchmarks.push_back(map("Vector3 lerp", d.v3out, [=](std::size_t i) { return lerp(v3a[i], v3b[i], 0.25f); }));
+			benchmarks.push_back(map("Vector3::magnitude", d.floats, [=](std::size_t i) { return v3a[i].magnitude(); }));
+			benchmarks.push_back(map("Vector3::magnitude Fast", d.floats, [=](std::size_t i) { return v3a[i].magnitude<Precision::Fast>(); }));
+			benchmarks.push_back(map("Vector3::normalized", d.v3out, [=](std::size_t i) { return v3a[i].normalized(); }));
+			benchmarks.push_back(map("Vector3::normalized Fast", d.v3out, [=](std::size_t i) { return v3a[i].normalized<Precision::Fast>(); }));
+			benchmarks.push_back(map("Vector3 angle", d.floats, [=](std::size_t i) { return angle(v3a[i], v3b[i]); }));
+			benchmarks.push_back(map("Vector3 angle Fast", d.floats, [=](std::size_t i) { return angle<Precision::Fast>(v3a[i], v3b[i]); }));
+			benchmarks.push_back(map("Vector3 distance", d.floats, [=](std::size_t i) { return distance(v3a[i], v3b[i]); }));
+
+			// Vector4.
+			benchmarks.push_back(map("Vector4 +", d.v4out, [=](std::size_t i) { return v4a[i] + v4b[i]; }));
+			benchmarks.push_back(map("Vector4 dot", d.floats, [=](std::size_t i) { return dot(v4a[i], v4b[i]); }));
+			benchmarks.push_back(map("Vector4::normalized", d.v4out, [=](std::size_t i) { return v4a[i].normalized(); }));
+			benchmarks.push_back(map("Vector4 distance", d.floats, [=](std::size_t i) { return distance(v4a[i], v4b[i]); }));
+
+			// Expression templates against the operator chain they replace.
+			benchmarks.push_back(map("Vector3 a + s * b + cross(a, b)", d.v3out, [=](std::size_t i)
+			{
+				return v3a[i] + scalars[i] * v3b[i] + cross(v3a[i], v3b[i]);
+			}));
+			benchmarks.push_back(map("expr a + s * b + cross(a, b)", d.v3out, [=](std::size_t i) -> Vector3
+			{
+				return expr::lazy(v3a[i]) + scalars[i] * expr::lazy(v3b[i]) + expr::cross(expr::lazy(v3a[i]), v3b[i]);
+			}));
+
+			// Quaternion.
+			benchmarks.push_back(map("Quaternion *", d.qout, [=](std::size_t i) { return qa[i] * qb[i]; }));
+			benchmarks.push_back(map("Quaternion * Vector3", d.v3out, [=](std::size_t i) { return qa[i] * v3a[i]; }));
+			benchmarks.push_back(map("Quaternion::normalized", d.qout, [=](std::size_t i) { return qb[i].normalized(); }));
+			benchmarks.push_back(map("Quaternion::inverse", d.qout, [=](std::size_t i) { return qa[i].inverse(); }));
+			benchmarks.push_back(map("Quaternion::angleAxis", d.qout, [=](std::size_t i) { return Quaternion::angleAxis(scalars[i], v3unit[i]); }));
+			benchmarks.push_back(map("Quaternion::euler", d.qout, [=](std::size_t i) { return Quaternion::euler(angles[i]); }));
+			benchmarks.push_back(map("Quaternion::euler Fast", d.qout, [=](std::size_t i) { return Quaternion::euler<Precision::Fast>(angles[i]); }));
+			benchmarks.push_back(map("Quaternion::fromToRotation", d.qout, [=](std::size_t i) { return Quaternion::fromToRotation(v3a[i], v3b[i]); }));
+			benchmarks.push_back(map("Quaternion::lookRotation", d.qout, [=](std::size_t i) { return Quaternion::lookRotation(v3a[i]); }));
+			benchmarks.push_back(map("Quaternion::lookRotation up", d.qout, [=](std::size_t i) { return Quaternion::lookRotation(v3a[i], v3b[i]); }));
+			benchmarks.push_back(map("Quaternion::rotateTowards", d.qout, [=](std::size_t i)
+			{
+				Quaternion q = qa[i];
+				q.rotateTowards(qb[i], 0.1f);
+				return q;
+			}));
+			benchmarks.push_back(map("Quaternion::rotateTowards Fast", d.qout, [=](std::size_t i)
+			{
+				Quaternion q = qa[i];
+				q.rotateTowards<Precision::Fast>(qb[i], 0.1f);
+				return q;
+			}));
+			benchmarks.push_back(map("Quaternion angle", d.floats, [=](std::size_t i) { return angle(qa[i], qb[i]); }));
+			benchmarks.push_back(map("Quaternion slerp", d.qout, [=](std::size_t i) { return slerp(qa[i], qb[i], factors[i]); }));
+			benchmarks.push_back(map("Quaternion slerp Fast", d.qout, [=](std::size_t i) { return slerp<Precision::Fast>(qa[i], qb[i], factors[i]); }));
+			benchmarks.push_back(map("Quaternion nlerp", d.qout, [=](std::size_t i) { return nlerp(qa[i], qb[i], factors[i]); }));
+
+			// Matrices.
+			benchmarks.push_back(map("Matrix2 *", d.m2out, [=](std::size_t i) { return m2a[i] * m2a[MAX_SIZE - 1 - i]; }));
+			benchmarks.push_back(map("Matrix2::inverse", d.m2out, [=](std::size_t i) { return m2a[i].inverse(); }));
+			benchmarks.push_back(map("Matrix2::angleRotation", d.m2out, [=](std::size_t i) { return Matrix2::angleRotation(scalars[i]); }));
+			benchmarks.push_back(map("Matrix3 *", d.m3out, [=](std::size_t i) { return m3a[i] * m3a[MAX_SIZE - 1 - i]; }));
+			benchmarks.push_back(map("Matrix3 * Vector3", d.v3out, [=](std::size_t i) { return m3a[i] * v3a[i]; }));
+			benchmarks.push_back(map("Matrix3::inverse", d.m3out, [=](std::size_t i) { return m3a[i].inverse(); }));
+			benchmarks.push_back(map("Matrix3::euler", d.m3out, [=](std::size_t i) { return Matrix3::euler(angles[i]); }));
+			benchmarks.push_back(map("Matrix3::angleAxis", d.m3out, [=](std::size_t i) { return Matrix3::angleAxis(scalars[i], v3unit[i]); }));
+			benchmarks.push_back(map("Matrix3::lookRotation", d.m3out, [=](std::size_t i) { return Matrix3::lookRotation(v3a[i], v3b[i]); }));
+			benchmarks.push_back(map("Matrix4 *", d.m4out, [=](std::size_t i) { return m4a[i] * m4rigid[i]; }));
+			benchmarks.push_back(map("Matrix4 * Vector4", d.v4out, [=](std::size_t i) { return m4a[i] * v4a[i]; }));
+			benchmarks.push_back(map("Matrix4::transposed", d.m4out, [=](std::size_t i) { return m4a[i].transposed(); }));
+			benchmarks.push_back(map("Matrix4::determinant", d.floats, [=](std::size_t i) { return m4a[i].determinant(); }));
+			benchmarks.push_back(map("Matrix4::inverse", d.m4out, [=](std::size_t i) { return m4a[i].inverse(); }));
+			benchmarks.push_back(map("Matrix4::inverseAffine", d.m4out, [=](std::size_t i) { return m4a[i].inverseAffine(); }));
+			benchmarks.push_back(map("Matrix4::inverseRigid", d.m4out, [=](std::size_t i) { return m4rigid[i].inverseRigid(); }));
+			benchmarks.push_back(map("Matrix4::euler", d.m4out, [=](std::size_t i) { return Matrix4::euler(angles[i]); }));
+			benchmarks.push_back(map("Matrix4::angleAxis", d.m4out, [=](std::size_t i) { return Matrix4::angleAxis(scalars[i], v3unit[i]); }));
+			benchmarks.push_back(map("Matrix4::fromToRotation", d.m4out, [=](std::size_t i) { return Matrix4::fromToRotation(v3a[i], v3b[i]); }));
+			benchmarks.push_back(map("Matrix4::lookRotation", d.m4out, [=](std::size_t i) { return Matrix4::lookRotation(v3a[i], v3b[i]); }));
+			benchmarks.push_back(map("Matrix4(Quaternion)", d.m4out, [=](std::size_t i) { return Matrix4(qa[i]); }));
+
+			// UnityMatrix4, against the Matrix4 operations above and against
+			// reading a Matrix4x4 into a Matrix4.
+			benchmarks.push_back(map("UnityMatrix4 *", d.u4out, [=](std::size_t i) { return u4a[i] * u4rigid[i]; }));
+			benchmarks.push_back(map("UnityMatrix4 * Vector4", d.v4out, [=](std::size_t i) { return u4a[i] * v4a[i]; }));
+			benchmarks.push_back(map("transposed Matrix4 * Vector4", d.v4out, [=](std::size_t i) { return Matrix4(u4a[i].data()).transposed() * v4a[i]; }));
+			benchmarks.push_back(map("UnityMatrix4::inverse", d.u4out, [=](std::size_t i) { return u4a[i].inverse(); }));
+			benchmarks.push_back(map("UnityMatrix4::inverseAffine", d.u4out, [=](std::size_t i) { return u4a[i].inverseAffine(); }));
+			benchmarks.push_back(map("UnityMatrix4::multiplyPoint3x4", d.v3out, [=](std::size_t i) { return u4a[i].multiplyPoint3x4(v3a[i]); }));
+
+			// Transform, against the Matrix4 operations above.
+			benchmarks.push_back(map("Transform *", d.tout, [=](std::size_t i) { return ta[i] * tb[i]; }));
+			benchmarks.push_back(map("Transform::inverse", d.tout, [=](std::size_t i) { return ta[i].inverse(); }));
+			benchmarks.push_back(map("Transform::transformPoint", d.v3out, [=](std::size_t i) { return ta[i].transformPoint(v3a[i]); }));
+			benchmarks.push_back(map("Transform::toMatrix4", d.m4out, [=](std::size_t i) { return ta[i].toMatrix4(); }));
+
+			// Batch kernels.
+			Data* data = &d;
+			benchmarks.push_back(Benchmark{"batch transformPoints", [=](std::size_t n)
+			{
+				transformPoints(m4a[0], v3a, data->v3out.data(), n);
+				doNotOptimize(data->v3out[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"batch transformDirections", [=](std::size_t n)
+			{
+				transformDirections(m4a[0], v3a, data->v3out.data(), n);
+				doNotOptimize(data->v3out[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"batch transformHomogeneous", [=](std::size_t n)
+			{
+				transformHomogeneous(m4a[0], v4a, data->v4out.data(), n);
+				doNotOptimize(data->v4out[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"batch rotate", [=](std::size_t n)
+			{
+				rotate(qa[0], v3a, data->v3out.data(), n);
+				doNotOptimize(data->v3out[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"batch rotate per element", [=](std::size_t n)
+			{
+				rotate(qa, v3a, data->v3out.data(), n);
+				doNotOptimize(data->v3out[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"batch slerp", [=](std::size_t n)
+			{
+				slerp(qa, qb, factors, data->qout.data(), n);
+				doNotOptimize(data->qout[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"batch slerp one factor", [=](std::size_t n)
+			{
+				slerp(qa, qb, 0.25f, data->qout.data(), n);
+				doNotOptimize(data->qout[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"batch nlerp", [=](std::size_t n)
+			{
+				nlerp(qa, qb, factors, data->qout.data(), n);
+				doNotOptimize(data->qout[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"batch euler Quaternion", [=](std::size_t n)
+			{
+				euler(angles, data->qout.data(), n);
+				doNotOptimize(data->qout[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"batch euler Quaternion Unity", [=](std::size_t n)
+			{
+				euler(data->anglesDegrees.data(), data->qout.data(), n, EulerConvention::UnityZXYDegrees);
+				doNotOptimize(data->qout[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"batch euler Matrix3", [=](std::size_t n)
+			{
+				euler(angles, data->m3out.data(), n);
+				doNotOptimize(data->m3out[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"batch euler Matrix4", [=](std::size_t n)
+			{
+				euler(angles, data->m4out.data(), n);
+				doNotOptimize(data->m4out[n - 1]);
+			}});
+
+			// A 60 degree perspective camera 10 units behind the origin, so
+			// that the inputs fall on both sides of the viewport edges.
+			const Matrix4 viewProjection = Matrix4(
+				0.974f, 0.0f, 0.0f, 0.0f,
+				0.0f, 1.732f, 0.0f, 0.0f,
+				0.0f, 0.0f, -1.006f, -0.6018f,
+				0.0f, 0.0f, -1.0f, 0.0f) * Matrix4::translation(Vector3(0.0f, 0.0f, -10.0f));
+			benchmarks.push_back(Benchmark{"batch project", [=](std::size_t n)
+			{
+				const Rect viewport(0.0f, 0.0f, 1920.0f, 1080.0f);
+				doNotOptimize(project(viewProjection, v3a, n, viewport, data->v2out.data(), data->floats.data(), data->flags.data()));
+			}});
+			const UnityMatrix4 unityViewProjection(viewProjection);
+			benchmarks.push_back(Benchmark{"batch project UnityMatrix4", [=](std::size_t n)
+			{
+				const Rect viewport(0.0f, 0.0f, 1920.0f, 1080.0f);
+				doNotOptimize(project(unityViewProjection, v3a, n, viewport, data->v2out.data(), data->floats.data(), data->flags.data()));
+			}});
+			const Frustum frustum(viewProjection);
+			benchmarks.push_back(Benchmark{"cull spheres", [=](std::size_t n)
+			{
+				doNotOptimize(cullSpheres(frustum, v3a, scalars, n, data->indices.data()));
+			}});
+			benchmarks.push_back(Benchmark{"cull boxes", [=](std::size_t n)
+			{
+				doNotOptimize(cullBoxes(frustum, v3a, v3unit, n, data->indices.data()));
+			}});
+
+			// SpatialGrid, queried at the points of v3b.
+			benchmarks.push_back(Benchmark{"grid build", [=](std::size_t n)
+			{
+				data->grid.build(v3a, n);
+				doNotOptimize(data->grid.size());
+			}});
+			benchmarks.push_back(Benchmark{"grid nearest", [=](std::size_t n)
+			{
+				std::uint32_t found = 0;
+				for (std::size_t i = 0; i < n; ++i) found ^= data->fullGrid.nearest(v3b[i]);
+				doNotOptimize(found);
+			}});
+			benchmarks.push_back(Benchmark{"grid radius", [=](std::size_t n)
+			{
+				data->indices.clear();
+				for (std::size_t i = 0; i < n; ++i) data->fullGrid.queryRadius(v3b[i], 0.25f, data->indices);
+				doNotOptimize(data->indices.size());
+			}});
+			for (std::size_t i = 0; i < d.executors.size(); ++i)
+			{
+				QueryExecutor* e = d.executors[i].get();
+				const std::string threads = std::to_string(d.pools[i]->size());
+				benchmarks.push_back(Benchmark{"grid nearest " + threads + " threads", [=](std::size_t n)
+				{
+					e->nearest(data->fullGrid, v3b, n, data->indices.data());
+					doNotOptimize(data->indices[n - 1]);
+				}});
+				benchmarks.push_back(Benchmark{"grid radius " + threads + " threads", [=](std::size_t n)
+				{
+					e->queryRadius(data->fullGrid, v3b, 0.25f, n, data->radiusResults);
+					doNotOptimize(data->radiusResults.items.size());
+				}});
+			}
+
+			// TransformHierarchy, changing the last n nodes, which have few
+			// descendants, against recomputing every world matrix.
+			const std::uint32_t* parents = d.parents.data();
+			benchmarks.push_back(Benchmark{"hierarchy update", [=](std::size_t n)
+			{
+				for (std::size_t i = MAX_SIZE - n; i < MAX_SIZE; ++i) data->hierarchy.setLocal(std::uint32_t(i), ta[i]);
+				data->hierarchy.update();
+				doNotOptimize(data->hierarchy.world(MAX_SIZE - 1));
+			}});
+			benchmarks.push_back(Benchmark{"hierarchy world", [=](std::size_t n)
+			{
+				for (std::size_t i = MAX_SIZE - n; i < MAX_SIZE; ++i) data->hierarchy.setLocal(std::uint32_t(i), ta[i]);
+				for (std::size_t i = MAX_SIZE - n; i < MAX_SIZE; ++i) doNotOptimize(data->hierarchy.world(std::uint32_t(i)));
+				data->hierarchy.update();
+			}});
+			benchmarks.push_back(Benchmark{"hierarchy recompute", [=](std::size_t n)
+			{
+				Matrix4* worlds = data->m4out.data();
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					const std::uint32_t p = parents[i];
+					worlds[i] = p == TransformHierarchy::NONE ? ta[i].toMatrix4() : worlds[p] * ta[i].toMatrix4();
+				}
+				doNotOptimize(worlds[n - 1]);
+			}});
+
+			// Vector3SoA kernels.
+			benchmarks.push_back(Benchmark{"soa dot", [=](std::size_t n)
+			{
+				const std::size_t k = data->soaIndex(n);
+				dot(data->soaA[k], data->soaB[k], data->floats.data());
+				doNotOptimize(data->floats[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"soa cross", [=](std::size_t n)
+			{
+				const std::size_t k = data->soaIndex(n);
+				cross(data->soaA[k], data->soaB[k], data->soaOut[k]);
+				doNotOptimize(data->soaOut[k].x()[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"soa distance", [=](std::size_t n)
+			{
+				const std::size_t k = data->soaIndex(n);
+				distance(v3b[0], data->soaA[k], data->floats.data());
+				doNotOptimize(data->floats[n - 1]);
+			}});
+			benchmarks.push_back(Benchmark{"soa normalize", [=](std::size_t n)
+			{
+				const std::size_t k = data->soaIndex(n);
+				doNotOptimize(normalize(data->soaA[k], data->soaOut[k]));
+			}});
+			benchmarks.push_back(Benchmark{"soa rotate", [=](std::size_t n)
+			{
+				const std::size_t k = data->soaIndex(n);
+				rotate(qa[0], data->soaA[k], data->soaOut[k]);
+				doNotOptimize(data->soaOut[k].x()[n - 1]);
+			}});
+		}
+	}
+}
+
+#if defined(M3D_BENCH_UNITY)
+namespace
+{
+	// Unity.h, on inputs converted from the M3D pools.
+	struct UnityData
+	{
+		std::vector<float> angles;
+		std::vector<Vector3> eulerAngles, locations, out;
+		std::vector<Quaternion> rotations, rotationsOut;
+
+		explicit UnityData(const M3D::bench::Data& d)
+		{
+			for (std::size_t i = 0; i < MAX_SIZE; ++i)
+			{
+				const M3D::Vector3& a = d.anglesDegrees[i];
+				const M3D::Vector3& p = d.v3a[i];
+				const M3D::Quaternion& q = d.qa[i];
+				angles.push_back(a.x * 6.0f);
+				eulerAngles.push_back(Vector3(a.x * 6.0f, a.y * 6.0f, a.z * 6.0f));
+				locations.push_back(Vector3(p.x, p.y, p.z));
+				rotations.push_back(Quaternion(q.x, q.y, q.z, q.w));
+			}
+			out.resize(MAX_SIZE);
+			rotationsOut.resize(MAX_SIZE);
+
+			// One 64-byte object per element, in shuffled order so that
+			// the hardware prefetcher cannot follow the pointers. Every
+			// 16th pointer is null.
+			objectPool.resize(MAX_SIZE * OBJECT_SIZE / sizeof(float));
+			for (std::size_t i = 0; i < MAX_SIZE; ++i)
+			{
+				const M3D::Vector3& p = d.v3a[i];
+				const Vector3 position(p.x, p.y, p.z);
+				std::memcpy(&objectPool[i * OBJECT_SIZE / sizeof(float)] + POSITION_OFFSET / sizeof(float), &position, sizeof(position));
+				objects.push_back(i % 16 == 5 ? nullptr : (char*)&objectPool[i * OBJECT_SIZE / sizeof(float)]);
+			}
+			std::shuffle(objects.begin(), objects.end(), std::mt19937(54321));
+			gathered.resize(3 * MAX_SIZE);
+			indices.resize(MAX_SIZE);
+		}
+
+		static const std::size_t OBJECT_SIZE = 64;
+		static const std::size_t POSITION_OFFSET = 36;
+		std::vector<float> objectPool;
+		std::vector<char*> objects;
+		std::vector<float> gathered;
+		std::vector<std::uint32_t> indices;
+	};
+
+	void addUnity(std::vector<Benchmark>& benchmarks, UnityData& u)
+	{
+		UnityData* data = &u;
+		benchmarks.push_back(Benchmark{"Unity NormalizeAngle", [=](std::size_t n)
+		{
+			float sum = 0.0f;
+			for (std::size_t i = 0; i < n; ++i) sum += NormalizeAngle(data->angles[i]);
+			doNotOptimize(sum);
+		}});
+		benchmarks.push_back(Benchmark{"Unity NormalizeAngles", [=](std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; ++i) data->out[i] = NormalizeAngles(data->eulerAngles[i]);
+			doNotOptimize(data->out[n - 1]);
+		}});
+		benchmarks.push_back(Benchmark{"Unity NormalizeAngles batch", [=](std::size_t n)
+		{
+			std::copy(data->eulerAngles.begin(), data->eulerAngles.begin() + n, data->out.begin());
+			NormalizeAngles(data->out.data(), n);
+			doNotOptimize(data->out[n - 1]);
+		}});
+		benchmarks.push_back(Benchmark{"Unity ToEulerRad", [=](std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; ++i) data->out[i] = ToEulerRad(data->rotations[i]);
+			doNotOptimize(data->out[n - 1]);
+		}});
+		benchmarks.push_back(Benchmark{"Unity ToEulerRad Fast", [=](std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; ++i) data->out[i] = ToEulerRad<M3D::Precision::Fast>(data->rotations[i]);
+			doNotOptimize(data->out[n - 1]);
+		}});
+		benchmarks.push_back(Benchmark{"Unity ToEulerRad batch", [=](std::size_t n)
+		{
+			ToEulerRad(data->rotations.data(), data->out.data(), n);
+			doNotOptimize(data->out[n - 1]);
+		}});
+		benchmarks.push_back(Benchmark{"Unity GetRotationToLocation", [=](std::size_t n)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				data->rotationsOut[i] = GetRotationToLocation(data->locations[i], 1.5f, data->locations[MAX_SIZE - 1 - i]);
+			}
+			doNotOptimize(data->rotationsOut[n - 1]);
+		}});
+		benchmarks.push_back(Benchmark{"Unity gather naive", [=](std::size_t n)
+		{
+			std::size_t k = 0;
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				if (!data->objects[i]) continue;
+				Vector3 p;
+				std::memcpy(&p, data->objects[i] + UnityData::POSITION_OFFSET, sizeof(p));
+				data->gathered[k] = p.X;
+				data->gathered[MAX_SIZE + k] = p.Y;
+				data->gathered[2 * MAX_SIZE + k] = p.Z;
+				++k;
+			}
+			doNotOptimize(k);
+		}});
+		const std::size_t distances[] = {0, 4, 8, 16, 32, 64};
+		for (const std::size_t distance : distances)
+		{
+			benchmarks.push_back(Benchmark{"Unity monoGather distance " + std::to_string(distance), [=](std::size_t n)
+			{
+				float* const lanes[3] = {&data->gathered[0], &data->gathered[MAX_SIZE], &data->gathered[2 * MAX_SIZE]};
+				const std::size_t k = monoGather(monoSpan<char*>(data->objects.data(), n),
+					monoField<Vector3>(UnityData::POSITION_OFFSET), lanes, data->indices.data(), distance);
+				doNotOptimize(k);
+			}});
+		}
+	}
+}
+#endif
+
+int main(int argc, char** argv)
+{
+	const char* filter = nullptr;
+	const char* jsonPath = nullptr;
+	const char* baselinePath = nullptr;
+	double minTime = 0.25;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--filter") == 0 && hasValue) filter = argv[++i];
+		else if (std::strcmp(argv[i], "--json") == 0 && hasValue) jsonPath = argv[++i];
+		else if (std::strcmp(argv[i], "--baseline") == 0 && hasValue) baselinePath = argv[++i];
+		else if (std::strcmp(argv[i], "--min-time") == 0 && hasValue) minTime = std::atof(argv[++i]);
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--filter TEXT] [--min-time SECONDS] [--json FILE] [--baseline FILE]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	std::mt19937 rng(12345);
+	M3D::bench::Data data(rng);
+	std::vector<Benchmark> benchmarks;
+	M3D::bench::add(benchmarks, data);
+#if defined(M3D_BENCH_UNITY)
+	UnityData unityData(data);
+	addUnity(benchmarks, unityData);
+#endif
+
+	std::map<std::pair<std::string, std::size_t>, double> baseline;
+	if (baselinePath)
+	{
+		baseline = loadBaseline(baselinePath);
+		if (baseline.empty())
+		{
+			std::fprintf(stderr, "warning: no results read from %s\n", baselinePath);
+		}
+	}
+
+	std::printf("%-36s %9s %12s %14s%s\n", "benchmark", "elements", "ns/element", "elements/s",
+		baseline.empty() ? "" : "   speedup");
+
+	std::vector<Result> results;
+	for (const Benchmark& benchmark : benchmarks)
+	{
+		if (filter && benchmark.name.find(filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		for (const std::size_t size : SIZES)
+		{
+			const Result result = measure(benchmark, size, minTime);
+			results.push_back(result);
+			std::printf("%-36s %9zu %12.3f %14.4g", result.name.c_str(), result.size, result.nsPerElement,
+				result.elementsPerSecond);
+
+			const auto previous = baseline.find(std::make_pair(result.name, result.size));
+			if (previous != baseline.end())
+			{
+				std::printf("   %6.2fx", previous->second / result.nsPerElement);
+			}
+			std::printf("\n");
+			std::fflush(stdout);
+		}
+	}
+
+	if (jsonPath && !saveJson(jsonPath, results))
+	{
+		std::fprintf(stderr, "error: could not write %s\n", jsonPath);
+		return 1;
+	}
+	return 0;
+}
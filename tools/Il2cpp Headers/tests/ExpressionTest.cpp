@@ -0,0 +1,108 @@
+// Tests that the expression templates give what the eager Vector3
+// operations they stand in for give.
+//
+// Build from this directory, with and without FMA, for example:
+//
+//	g++ -std=c++17 -O2 -I.. ExpressionTest.cpp ../*.cpp -o expression-test
+//	g++ -std=c++17 -O2 -mfma -I.. ExpressionTest.cpp ../*.cpp -o expression-test
+//
+// Exits with 0 when every check passed.
+
+#include <M3D/Expression.hpp>
+#include <M3D/Vector3.hpp>
+#include <M3D/Vector4.hpp>
+
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+	using M3D::Vector3;
+	using M3D::Vector4;
+
+	int failures = 0;
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			++failures; \
+		} \
+	} \
+	while (0)
+
+	bool identical(const Vector3& a, const Vector3& b)
+	{
+		return a.x == b.x && a.y == b.y && a.z == b.z;
+	}
+
+	bool identical(const Vector4& a, const Vector4& b)
+	{
+		return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+	}
+
+#if defined(FP_FAST_FMAF)
+	bool close(const Vector3& a, const Vector3& b)
+	{
+		const float scale = std::fmax(1.0f, std::fmax(a.magnitude(), b.magnitude()));
+		return (a - b).magnitude() <= 1e-6f * scale;
+	}
+#endif
+
+	void testLerp()
+	{
+		const Vector3 ends[][2] = {
+			{Vector3(1e8f, -1e8f, 3.0f), Vector3(1.0f, 1.0f, -7.0f)},
+			{Vector3(0.1f, 0.2f, 0.3f), Vector3(-1e-7f, 5e7f, 0.7f)},
+			{Vector3(-4.5f, 1e-30f, 1e30f), Vector3(4.5f, -1e-30f, -1e30f)},
+		};
+
+		for (const auto& e : ends)
+		{
+			const Vector3& from = e[0];
+			const Vector3& to = e[1];
+
+			// The ends are exact, as in M3D::lerp.
+			const Vector3 start = M3D::expr::lerp(M3D::expr::lazy(from), to, 0.0f);
+			const Vector3 end = M3D::expr::lerp(M3D::expr::lazy(from), to, 1.0f);
+			CHECK(identical(start, M3D::lerp(from, to, 0.0f)));
+			CHECK(identical(end, M3D::lerp(from, to, 1.0f)));
+			CHECK(identical(start, from));
+			CHECK(identical(end, to));
+
+			// In between, the only difference is the FMA rounding.
+			for (const float factor : {0.25f, 0.5f, 0.9f})
+			{
+				const Vector3 lazy = M3D::expr::lerp(M3D::expr::lazy(from), to, factor);
+				const Vector3 eager = M3D::lerp(from, to, factor);
+#if defined(FP_FAST_FMAF)
+				CHECK(close(lazy, eager));
+#else
+				CHECK(identical(lazy, eager));
+#endif
+			}
+		}
+
+		// Either operand may be an expression.
+		const Vector3 a(1e8f, 2.0f, -3.0f), b(0.5f, 0.5f, 0.5f), c(1.0f, -1.0f, 2.0f);
+		CHECK(identical(M3D::expr::lerp(M3D::expr::lazy(a) + b, c, 1.0f), c));
+		CHECK(identical(M3D::expr::lerp(c, M3D::expr::lazy(a) - b, 0.0f), c));
+
+		const Vector4 from4(1e8f, 1.0f, -2.0f, 0.5f), to4(1.0f, 2.0f, 3.0f, -0.5f);
+		CHECK(identical(M3D::expr::lerp(M3D::expr::lazy(from4), to4, 0.0f), from4));
+		CHECK(identical(M3D::expr::lerp(M3D::expr::lazy(from4), to4, 1.0f), to4));
+	}
+}
+
+int main()
+{
+	testLerp();
+
+	if (failures == 0)
+	{
+		std::printf("all passed\n");
+	}
+	return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+// Tests the nearest neighbour queries of SpatialGrid against a linear scan,
+// on grids that leave them a lot of empty space to cross.
+//
+// Build from this directory, for example:
+//
+//	g++ -std=c++17 -O2 -I.. SpatialGridTest.cpp ../SpatialGrid.cpp -o spatial-grid-test
+//
+// Exits with 0 when every check passed.
+
+#include <M3D/SpatialGrid.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using M3D::SpatialGrid;
+	using M3D::Vector3;
+
+	int failures = 0;
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			++failures; \
+		} \
+	} \
+	while (0)
+
+	// The k points closest to p, as queryNearest() orders them.
+	std::vector<SpatialGrid::Neighbor> scan(const std::vector<Vector3>& points, const Vector3& p, std::size_t k)
+	{
+		std::vector<SpatialGrid::Neighbor> all;
+		for (std::size_t i = 0; i < points.size(); ++i)
+		{
+			const Vector3 d = points[i] - p;
+			all.push_back(SpatialGrid::Neighbor{std::uint32_t(i), d.x * d.x + d.y * d.y + d.z * d.z});
+		}
+		std::sort(all.begin(), all.end(), [](const SpatialGrid::Neighbor& a, const SpatialGrid::Neighbor& b)
+		{
+			return a.sqrDistance < b.sqrDistance || (a.sqrDistance == b.sqrDistance && a.index < b.index);
+		});
+		all.resize(std::min(k, all.size()));
+		return all;
+	}
+
+	bool same(const std::vector<SpatialGrid::Neighbor>& a, const std::vector<SpatialGrid::Neighbor>& b)
+	{
+		if (a.size() != b.size()) return false;
+		for (std::size_t i = 0; i < a.size(); ++i)
+		{
+			if (a[i].index != b[i].index || a[i].sqrDistance != b[i].sqrDistance) return false;
+		}
+		return true;
+	}
+
+	void testOutlier(std::mt19937& rng)
+	{
+		// 100000 points in a 10^3 box and one far from it: the occupied
+		// range is 400 cells wide and almost all of it empty.
+		std::uniform_real_distribution<float> box(-5.0f, 5.0f);
+		std::vector<Vector3> points;
+		for (int i = 0; i < 100000; ++i) points.push_back(Vector3(box(rng), box(rng), box(rng)));
+		points.push_back(Vector3(400.0f, 400.0f, 400.0f));
+		SpatialGrid grid(1.0f);
+		grid.build(points.data(), points.size());
+
+		const Vector3 queries[] = {
+			Vector3(200.0f, 200.0f, 200.0f), Vector3(390.0f, 390.0f, 390.0f), Vector3(150.0f, 0.0f, 300.0f),
+			Vector3(-50.0f, 120.0f, 60.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(1000.0f, -1000.0f, 400.0f)
+		};
+
+		// Each of these took close to a second when the search walked every
+		// cell out to the answer.
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::vector<std::uint32_t> found;
+		for (const Vector3& q : queries) found.push_back(grid.nearest(q));
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		CHECK(seconds < 0.5);
+
+		for (std::size_t i = 0; i < found.size(); ++i)
+		{
+			const std::vector<SpatialGrid::Neighbor> expected = scan(points, queries[i], 1);
+			CHECK(found[i] == expected[0].index);
+		}
+		CHECK(grid.nearest(Vector3(390.0f, 390.0f, 390.0f)) == 100000);
+	}
+
+	void testSparse(std::mt19937& rng)
+	{
+		// 1000 points over 300^3, a cell each at most.
+		std::uniform_real_distribution<float> wide(-150.0f, 150.0f);
+		std::vector<Vector3> points;
+		for (int i = 0; i < 1000; ++i) points.push_back(Vector3(wide(rng), wide(rng), wide(rng)));
+		SpatialGrid grid(1.0f);
+		grid.build(points.data(), points.size());
+
+		std::vector<SpatialGrid::Neighbor> out;
+		for (int i = 0; i < 50; ++i)
+		{
+			const Vector3 q(wide(rng), wide(rng), wide(rng));
+			grid.queryNearest(q, 20, out);
+			CHECK(same(out, scan(points, q, 20)));
+
+			// Every point, once each, in order.
+			grid.queryNearest(q, points.size() + 1, out);
+			CHECK(same(out, scan(points, q, points.size())));
+		}
+
+		// Points moved to another cell are seen once, from the moved list.
+		for (std::uint32_t i = 0; i < 20; ++i)
+		{
+			points[i] = Vector3(wide(rng), wide(rng), wide(rng));
+			grid.update(i, points[i]);
+		}
+		for (int i = 0; i < 20; ++i)
+		{
+			const Vector3 q(wide(rng), wide(rng), wide(rng));
+			grid.queryNearest(q, 2 * points.size(), out);
+			CHECK(same(out, scan(points, q, points.size())));
+			CHECK(grid.nearest(q) == out[0].index);
+		}
+	}
+}
+
+int main()
+{
+	std::mt19937 rng(19);
+	testOutlier(rng);
+	testSparse(rng);
+
+	if (failures == 0)
+	{
+		std::printf("all passed\n");
+	}
+	return failures == 0 ? 0 : 1;
+}
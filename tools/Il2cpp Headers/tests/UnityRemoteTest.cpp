@@ -0,0 +1,250 @@
+// Tests monoRemoteReader against a child process holding mock il2cpp
+// containers.
+//
+// Build from this directory, with the Unity-style Vector3.hpp and
+// Quaternion.hpp that Unity.h includes on the include path, for example:
+//
+//     g++ -std=c++17 -O1 -g -fsanitize=address,undefined -I.. -I<unity headers> UnityRemoteTest.cpp -o unity-remote-test
+//
+// The containers are built before fork(), so they sit at the same
+// addresses in the child, and the parent then clobbers its own copies: a
+// read that silently came from the parent's memory would fail the checks.
+// Exits with 0 when every check passed.
+
+#include "../UnityRemote.h"
+
+#include <sys/wait.h>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures;                                                         \
+        }                                                                       \
+    } while (0)
+
+// Storage for a monoArray<E *> of length elements, with the header that
+// offsetof(monoArray, vector) expects.
+template <typename E>
+monoArray<E *> *makeArray(size_t length){
+    const size_t bytes = offsetof(monoArray<E *>, vector) + std::max<size_t>(length, 1) * sizeof(E);
+    monoArray<E *> *array = (monoArray<E *> *)std::calloc(1, bytes);
+    array->max_length = (void *)(uintptr_t)length;
+    return array;
+}
+
+struct Entity {
+    void *klass;
+    void *monitor;
+    int id;
+    float position[3];
+};
+
+const size_t ENTITY_POSITION = offsetof(Entity, position);
+
+// What the child holds.
+struct Mock {
+    monoList<int *> smallList;
+    monoList<int *> largeList;
+    monoDictionary<int *, float *> dictionary;
+    Entity entities[4];
+};
+
+const int SMALL = 100;
+const int LARGE = 5000;   // spans more pages than the cache takes
+const int SLOTS = 10;
+
+void build(Mock &mock){
+    mock.smallList = monoList<int *>();
+    mock.smallList.items = makeArray<int>(128);
+    mock.smallList.size = SMALL;
+    for (int i = 0; i < SMALL; ++i)
+        mock.smallList.items->span()[(size_t)i] = i * 3;
+
+    mock.largeList = monoList<int *>();
+    mock.largeList.items = makeArray<int>(LARGE);
+    mock.largeList.size = LARGE;
+    for (int i = 0; i < LARGE; ++i)
+        mock.largeList.items->span()[(size_t)i] = LARGE - i;
+
+    // Odd slots are free.
+    mock.dictionary = monoDictionary<int *, float *>();
+    monoArray<monoLink *> *links = makeArray<monoLink>(16);
+    mock.dictionary.linkSlots = (monoArray<void **> *)links;
+    mock.dictionary.keys = makeArray<int>(16);
+    mock.dictionary.values = makeArray<float>(16);
+    mock.dictionary.touchedSlots = SLOTS;
+    for (int i = 0; i < SLOTS; ++i) {
+        links->span()[(size_t)i] = monoLink{i % 2 == 0 ? (i | MONO_HASH_FLAG) : 0, MONO_NO_SLOT};
+        mock.dictionary.keys->span()[(size_t)i] = 100 + i;
+        mock.dictionary.values->span()[(size_t)i] = 0.5f * (float)i;
+    }
+
+    for (int i = 0; i < 4; ++i)
+        mock.entities[i] = Entity{nullptr, nullptr, i, {(float)i, 2.0f * (float)i, -1.0f}};
+}
+
+void clobber(Mock &mock){
+    for (int i = 0; i < SMALL; ++i)
+        mock.smallList.items->span()[(size_t)i] = -1;
+    for (int i = 0; i < LARGE; ++i)
+        mock.largeList.items->span()[(size_t)i] = -1;
+    for (int i = 0; i < SLOTS; ++i)
+        mock.dictionary.values->span()[(size_t)i] = -1.0f;
+    for (Entity &entity : mock.entities)
+        entity.position[0] = entity.position[1] = entity.position[2] = -1.0f;
+}
+
+void destroy(Mock &mock){
+    std::free(mock.smallList.items);
+    std::free(mock.largeList.items);
+    std::free(mock.dictionary.linkSlots);
+    std::free(mock.dictionary.keys);
+    std::free(mock.dictionary.values);
+}
+
+void testContainers(monoRemoteReader &reader, Mock &mock){
+    std::vector<int> small;
+    CHECK(reader.readList(&mock.smallList, small));
+    CHECK(small.size() == (size_t)SMALL);
+    for (int i = 0; i < SMALL && i < (int)small.size(); ++i)
+        CHECK(small[(size_t)i] == i * 3);
+
+    std::vector<int> large;
+    CHECK(reader.readList(&mock.largeList, large));
+    CHECK(large.size() == (size_t)LARGE);
+    for (int i = 0; i < LARGE && i < (int)large.size(); ++i)
+        CHECK(large[(size_t)i] == LARGE - i);
+
+    std::vector<int> items;
+    CHECK(reader.readArray(mock.smallList.items, items));
+    CHECK(items.size() == 128);
+
+    std::vector<std::pair<int, float>> entries;
+    CHECK(reader.readDictionary(&mock.dictionary, entries));
+    CHECK(entries.size() == SLOTS / 2);
+    for (size_t i = 0; i < entries.size(); ++i)
+        CHECK(entries[i].first == 100 + 2 * (int)i && entries[i].second == (float)i);
+}
+
+void testBatch(monoRemoteReader &reader, Mock &mock){
+    // Every request of a batch goes out in one syscall, with the reads of
+    // the same page served by one cached copy of it.
+    reader.invalidate();
+    int ids[4] = {};
+    size_t tickets[4];
+    const size_t before = reader.syscalls;
+    for (int i = 0; i < 4; ++i)
+        tickets[i] = reader.request((uintptr_t)&mock.entities[i].id, ids[i]);
+    int unreadable = 0;
+    const size_t bad = reader.request((uintptr_t)16, unreadable);
+    CHECK(reader.flush() == 1);
+    CHECK(reader.syscalls - before <= 2);
+    for (int i = 0; i < 4; ++i) {
+        CHECK(reader.succeeded(tickets[i]));
+        CHECK(ids[i] == i);
+    }
+    CHECK(!reader.succeeded(bad));
+
+    Entity *objects[6] = {&mock.entities[0], nullptr, &mock.entities[1], &mock.entities[2], nullptr, &mock.entities[3]};
+    float positions[6][3];
+    std::vector<bool> valid;
+    CHECK(reader.gather(objects, 6, ENTITY_POSITION, positions, valid) == 4);
+    for (size_t i = 0; i < 6; ++i) {
+        CHECK(valid[i] == (objects[i] != nullptr));
+        if (objects[i])
+            CHECK(positions[i][0] == (float)objects[i]->id && positions[i][1] == 2.0f * (float)objects[i]->id);
+    }
+}
+
+void testCache(monoRemoteReader &reader, Mock &mock){
+    reader.invalidate();
+    std::vector<int> small;
+    CHECK(reader.readList(&mock.smallList, small));
+    const size_t misses = reader.pageMisses;
+    const size_t hits = reader.pageHits;
+    CHECK(reader.readList(&mock.smallList, small));
+    CHECK(reader.pageMisses == misses);
+    CHECK(reader.pageHits > hits);
+
+    reader.invalidate();
+    CHECK(reader.readList(&mock.smallList, small));
+    CHECK(reader.pageMisses > misses);
+}
+
+void testReuseAfterFlush(monoRemoteReader &reader, Mock &mock){
+    // The destinations of a flushed batch may be gone: nothing may write
+    // to them again.
+    {
+        std::vector<int> small;
+        CHECK(reader.readList(&mock.smallList, small));
+    }
+    Entity *nulls[2] = {nullptr, nullptr};
+    float positions[2][3];
+    std::vector<bool> valid;
+    CHECK(reader.gather(nulls, 2, ENTITY_POSITION, positions, valid) == 0);
+    CHECK(!valid[0] && !valid[1]);
+    CHECK(reader.gather(nulls, 0, ENTITY_POSITION, positions, valid) == 0);
+
+    {
+        std::vector<std::pair<int, float>> entries;
+        CHECK(reader.readDictionary(&mock.dictionary, entries));
+    }
+    CHECK(reader.flush() == 0);
+    CHECK(reader.flush() == 0);
+
+    int id = 0;
+    const size_t ticket = reader.request((uintptr_t)&mock.entities[3].id, id);
+    CHECK(reader.flush() == 0);
+    CHECK(reader.succeeded(ticket) && id == 3);
+    CHECK(reader.flush() == 0);
+    CHECK(!reader.succeeded(ticket));
+}
+
+}
+
+int main(){
+    std::unique_ptr<Mock> mock(new Mock());
+    build(*mock);
+
+    int gate[2];
+    if (pipe(gate) != 0) {
+        std::perror("pipe");
+        return 1;
+    }
+    const pid_t child = fork();
+    if (child < 0) {
+        std::perror("fork");
+        return 1;
+    }
+    if (child == 0) {
+        // Holds the containers until the parent closes the pipe.
+        close(gate[1]);
+        char byte;
+        while (::read(gate[0], &byte, 1) > 0) {}
+        _exit(0);
+    }
+    close(gate[0]);
+    clobber(*mock);
+
+    monoRemoteReader reader(child, 4);
+    testContainers(reader, *mock);
+    testBatch(reader, *mock);
+    testCache(reader, *mock);
+    testReuseAfterFlush(reader, *mock);
+
+    close(gate[1]);
+    waitpid(child, nullptr, 0);
+    destroy(*mock);
+
+    if (failures == 0)
+        std::printf("all passed\n");
+    return failures == 0 ? 0 : 1;
+}